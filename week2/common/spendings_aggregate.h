@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Aggregates of a part of a ledger, merged into the aggregates of the whole one by MergeFrom.
+// Spending is the ledger item of the task, {category, amount}.
+template <typename Spending>
+struct SpendingsAggregate {
+  int64_t total = 0;
+  std::map<std::string, int64_t, std::less<>> category_totals;
+  std::vector<Spending> top;  // the top_k most expensive by descending amount, earlier ones first among equal
+
+  void Add(std::string_view category, int amount, size_t top_k) {
+    total += amount;
+    auto it = category_totals.find(category);
+    if (it == category_totals.end()) {
+      it = category_totals.emplace(std::string(category), 0).first;
+    }
+    it->second += amount;
+
+    if (top.size() < top_k || (!top.empty() && top.back().amount < amount)) {
+      auto pos = std::upper_bound(std::begin(top), std::end(top), amount, [](int value, const Spending& s) {
+        return value > s.amount;
+      });
+      top.insert(pos, Spending{std::string(category), amount});
+      if (top.size() > top_k) {
+        top.pop_back();
+      }
+    }
+  }
+
+  // other covers the part of the ledger right after this one
+  void MergeFrom(SpendingsAggregate other, size_t top_k) {
+    total += other.total;
+    for (auto& [category, amount] : other.category_totals) {
+      category_totals[category] += amount;
+    }
+
+    std::vector<Spending> merged_top;
+    merged_top.reserve(top.size() + other.top.size());
+    std::merge(std::make_move_iterator(std::begin(top)), std::make_move_iterator(std::end(top)),
+               std::make_move_iterator(std::begin(other.top)), std::make_move_iterator(std::end(other.top)),
+               std::back_inserter(merged_top), [](const Spending& lhs, const Spending& rhs) {
+                 return lhs.amount > rhs.amount;
+               });
+    if (merged_top.size() > top_k) {
+      merged_top.resize(top_k);
+    }
+    top = std::move(merged_top);
+  }
+};
+
+// Splits the ledger text into about chunk_count parts, but no more than the hardware runs at once,
+// aggregates the parts in parallel and merges the results in order.
+// part_end(input, pos) is the end of the part that should end near pos: right after the record that goes on at pos.
+// It is called in order of the parts, with pos at or after the end it returned before, so it may keep scan state.
+// for_each_spending(part, callback) calls callback(category, amount) for every spending of a part.
+// An exception thrown for a part is rethrown here, for the first such part in the input.
+template <typename Spending, typename PartEnd, typename ForEachSpending>
+SpendingsAggregate<Spending> AggregateSpendingsInParts(
+  std::string_view input, size_t top_k, size_t chunk_count, PartEnd part_end, ForEachSpending for_each_spending
+) {
+  const size_t thread_count = std::max(1u, std::thread::hardware_concurrency());
+  const size_t part_count = std::clamp<size_t>(chunk_count, 1, thread_count);
+  std::vector<std::future<SpendingsAggregate<Spending>>> part_aggregates;
+
+  size_t part_begin = 0;
+  for (size_t part_idx = 1; part_idx <= part_count && part_begin < input.size(); ++part_idx) {
+    size_t end_pos = input.size();
+    if (part_idx < part_count) {
+      end_pos = std::clamp(part_end(input, std::max(part_begin, input.size() / part_count * part_idx)), part_begin, input.size());
+    }
+
+    const std::string_view part = input.substr(part_begin, end_pos - part_begin);
+    part_aggregates.push_back(std::async(part_count == 1 ? std::launch::deferred : std::launch::async,
+                                         [part, top_k, &for_each_spending] {
+      SpendingsAggregate<Spending> res;
+      for_each_spending(part, [&res, top_k](std::string_view category, int amount) {
+        res.Add(category, amount, top_k);
+      });
+      return res;
+    }));
+    part_begin = end_pos;
+  }
+
+  SpendingsAggregate<Spending> res;
+  for (auto& part_aggregate : part_aggregates) {
+    res.MergeFrom(part_aggregate.get(), top_k);
+  }
+  return res;
+}
@@ -0,0 +1,52 @@
+#include "profile.h"
+#include "xml.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// The way Node::AttributeValue read every attribute before typed values were cached
+template <typename T>
+T AttributeValueThroughStream(const Node &node, const string &name) {
+    istringstream attr_input(node.AttributeValue<string>(name));
+    T result;
+    attr_input >> result;
+    return result;
+}
+
+// Usage: attribute_benchmark [spend_count] [pass_count]
+int main(int argc, char *argv[]) {
+    const int spend_count = argc > 1 ? stoi(argv[1]) : 100000;
+    const int pass_count = argc > 2 ? stoi(argv[2]) : 20;
+
+    Node july("july", {});
+    for (int i = 0; i < spend_count; ++i) {
+        july.AddChild(Node("spend", {{"amount",   to_string(i % 10000)},
+                                     {"category", "category" + to_string(i % 17)}}));
+    }
+
+    long long stream_total = 0;
+    {
+        LOG_DURATION("istringstream per read");
+        for (int pass = 0; pass < pass_count; ++pass) {
+            for (const Node &spend : july.Children()) {
+                stream_total += AttributeValueThroughStream<int>(spend, "amount");
+            }
+        }
+    }
+
+    long long cached_total = 0;
+    {
+        LOG_DURATION("cached typed value");
+        for (int pass = 0; pass < pass_count; ++pass) {
+            for (const Node &spend : july.Children()) {
+                cached_total += spend.AttributeValue<int>("amount");
+            }
+        }
+    }
+
+    cout << stream_total << ' ' << cached_total << endl;
+    return stream_total == cached_total ? 0 : 1;
+}
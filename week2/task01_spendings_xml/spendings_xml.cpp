@@ -1,9 +1,13 @@
 #include "xml.h"
+#include "spendings_aggregate.h"
 #include "test_runner.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -54,6 +58,30 @@ vector<Spending> LoadFromXml(istream &input) {
     return res;
 }
 
+// Calls callback for each spend element of the ledger, reading it with PullParser instead of building a Document
+template <typename Callback>
+void ForEachSpendingInXml(string_view input, Callback callback) {
+    PullParser parser(input);
+    for (PullParser::Event event; (event = parser.Next()) != PullParser::Event::EndDocument;) {
+        if (event == PullParser::Event::StartElement && parser.Name() == "spend") {
+            callback(parser.AttributeValue<string_view>("category"), parser.AttributeValue<int>("amount"));
+        }
+    }
+}
+
+// Aggregates a ledger in parallel parts read with ForEachSpendingInXml, see AggregateSpendingsInParts.
+// Parts are split right before a "<spend" tag, so the ledger must not have it inside comments or attribute values.
+SpendingsAggregate<Spending> AggregateSpendingsXml(string_view input, size_t top_k, size_t chunk_count) {
+    return AggregateSpendingsInParts<Spending>(
+            input, top_k, chunk_count,
+            [](string_view text, size_t pos) {
+                return min(text.find("<spend", pos), text.size());
+            },
+            [](string_view part, auto callback) {
+                ForEachSpendingInXml(part, callback);
+            });
+}
+
 void TestLoadFromXml() {
     istringstream xml_input(R"(<july>
     <spend amount="2500" category="food"></spend>
@@ -77,6 +105,159 @@ void TestLoadFromXml() {
     ASSERT_EQUAL(spendings, expected);
 }
 
+void TestAggregateSpendingsXml() {
+    // attributes come in either order and quoting, with spaces around '=', some tags are self-closing,
+    // span several lines or are preceded by a comment
+    const vector<string> categories = {"food", "transport", "restaurants", "clothes", "travel", "sport"};
+    ostringstream xml_output;
+    vector<Spending> spendings;
+    xml_output << "<?xml version=\"1.0\"?>\n<july>\n";
+    for (int i = 0; i < 1000; ++i) {
+        spendings.push_back({categories[i % categories.size()], (i * 7919) % 1000 - 100});
+        const Spending &s = spendings.back();
+        switch (i % 4) {
+            case 0:
+                xml_output << "  <spend amount=\"" << s.amount << "\" category=\"" << s.category << "\"></spend>\n";
+                break;
+            case 1:
+                xml_output << "  <spend category='" << s.category << "' amount = '" << s.amount << "'/>\n";
+                break;
+            case 2:
+                xml_output << "  <!-- paid in cash -->\n  <spend\n    category=\"" << s.category
+                           << "\"\n    amount=\"" << s.amount << "\"\n  />\n";
+                break;
+            default:
+                xml_output << "  <spend note=\"a b\" amount=" << s.amount << " category=\"" << s.category << "\"/>";
+                break;
+        }
+    }
+    xml_output << "</july>";
+    const string xml_input = xml_output.str();
+
+    map<string, int64_t, less<>> expected_category_totals;
+    for (const Spending &s : spendings) {
+        expected_category_totals[s.category] += s.amount;
+    }
+    vector<Spending> expected_top = spendings;
+    stable_sort(begin(expected_top), end(expected_top), [](const Spending &lhs, const Spending &rhs) {
+        return lhs.amount > rhs.amount;
+    });
+    expected_top.resize(5);
+
+    for (size_t chunk_count : {1, 2, 3, 8, 5000}) {
+        const SpendingsAggregate<Spending> aggregate = AggregateSpendingsXml(xml_input, 5, chunk_count);
+        ASSERT_EQUAL(aggregate.total, CalculateTotalSpendings(spendings));
+        ASSERT(aggregate.category_totals == expected_category_totals);
+        ASSERT_EQUAL(aggregate.top, expected_top);
+        ASSERT_EQUAL(aggregate.top.front().category, MostExpensiveCategory(spendings));
+    }
+
+    const SpendingsAggregate<Spending> empty_aggregate = AggregateSpendingsXml("<july>\n</july>", 5, 4);
+    ASSERT_EQUAL(empty_aggregate.total, 0);
+    ASSERT(empty_aggregate.top.empty());
+}
+
+void TestPullParser() {
+    PullParser parser(R"(<?xml version="1.0"?>
+<july>
+    <spend amount="2500" category="food"></spend>
+    <!-- no spendings yet -->
+    <spend category='travel'  amount = "23740"/>
+</july>)");
+
+    ASSERT(parser.Next() == PullParser::Event::StartElement);
+    ASSERT_EQUAL(parser.Name(), "july");
+    ASSERT(!parser.Attribute("amount").has_value());
+
+    ASSERT(parser.Next() == PullParser::Event::StartElement);
+    ASSERT_EQUAL(parser.Name(), "spend");
+    ASSERT_EQUAL(parser.AttributeValue<int>("amount"), 2500);
+    ASSERT_EQUAL(parser.AttributeValue<string>("category"), "food");
+    ASSERT(parser.Next() == PullParser::Event::EndElement);
+    ASSERT_EQUAL(parser.Name(), "spend");
+
+    ASSERT(parser.Next() == PullParser::Event::StartElement);
+    ASSERT_EQUAL(parser.AttributeValue<int>("amount"), 23740);
+    ASSERT_EQUAL(parser.AttributeValue<string_view>("category"), "travel");
+    ASSERT(parser.Next() == PullParser::Event::EndElement);
+
+    ASSERT(parser.Next() == PullParser::Event::EndElement);
+    ASSERT_EQUAL(parser.Name(), "july");
+    ASSERT(parser.Next() == PullParser::Event::EndDocument);
+    ASSERT(parser.Next() == PullParser::Event::EndDocument);
+}
+
+void TestPullParserQuotesAndComments() {
+    PullParser parser(R"(<july>
+    <!-- <spend amount="1" category="comment"/> and a > inside -->
+    <spend category="a > b" note='<x/>' amount="2500"/>
+    <spend amount="12abc" category="food"/>
+    <spend amount="3000000000" category="food"/>
+</july>)");
+
+    ASSERT(parser.Next() == PullParser::Event::StartElement);
+    ASSERT(parser.Next() == PullParser::Event::StartElement);
+    ASSERT_EQUAL(parser.AttributeValue<string_view>("category"), "a > b");
+    ASSERT_EQUAL(parser.AttributeValue<string_view>("note"), "<x/>");
+    ASSERT_EQUAL(parser.AttributeValue<int>("amount"), 2500);
+    ASSERT(parser.Next() == PullParser::Event::EndElement);
+
+    // values that are not whole numbers of the requested type are rejected
+    for (int i = 0; i < 2; ++i) {
+        ASSERT(parser.Next() == PullParser::Event::StartElement);
+        bool is_rejected = false;
+        try {
+            parser.AttributeValue<int>("amount");
+        } catch (const invalid_argument &) {
+            is_rejected = true;
+        }
+        ASSERT(is_rejected);
+        ASSERT(parser.Next() == PullParser::Event::EndElement);
+    }
+
+    ASSERT(parser.Next() == PullParser::Event::EndElement);
+    ASSERT_EQUAL(parser.Name(), "july");
+    ASSERT(parser.Next() == PullParser::Event::EndDocument);
+}
+
+void TestForEachSpendingInXml() {
+    const string xml_input = R"(<july>
+    <spend amount="2500" category="food"></spend>
+    <spend amount="1150" category="transport"></spend>
+    <spend amount="23740" category="travel"></spend>
+  </july>)";
+
+    vector<Spending> spendings;
+    ForEachSpendingInXml(xml_input, [&spendings](string_view category, int amount) {
+        spendings.push_back({string(category), amount});
+    });
+
+    istringstream xml_stream(xml_input);
+    ASSERT_EQUAL(spendings, LoadFromXml(xml_stream));
+}
+
+void TestTypedAttributeValue() {
+    Node spend("spend", {{"amount",   "2500"},
+                         {"rate",     "0.25"},
+                         {"padded",   " 42"},
+                         {"partial",  "12abc"},
+                         {"big",      "3000000000"},
+                         {"category", "food"}});
+
+    ASSERT_EQUAL(spend.AttributeValue<int>("amount"), 2500);
+    ASSERT_EQUAL(spend.AttributeValue<long long>("amount"), 2500);
+    ASSERT_EQUAL(spend.AttributeValue<double>("amount"), 2500.0);
+    ASSERT_EQUAL(spend.AttributeValue<double>("rate"), 0.25);
+    ASSERT_EQUAL(spend.AttributeValue<string>("amount"), "2500");
+    ASSERT_EQUAL(spend.AttributeValue<string>("category"), "food");
+
+    // texts that are not whole numbers are read by istream as before
+    ASSERT_EQUAL(spend.AttributeValue<int>("padded"), 42);
+    ASSERT_EQUAL(spend.AttributeValue<int>("partial"), 12);
+    ASSERT_EQUAL(spend.AttributeValue<long long>("big"), 3000000000LL);
+    ASSERT_EQUAL(spend.AttributeValue<int>("big"), numeric_limits<int>::max());
+}
+
 void TestXmlLibrary() {
     // Тест демонстрирует, как пользоваться библиотекой из файла xml.h
 
@@ -110,4 +291,9 @@ int main() {
     TestRunner tr;
     RUN_TEST(tr, TestXmlLibrary);
     RUN_TEST(tr, TestLoadFromXml);
+    RUN_TEST(tr, TestAggregateSpendingsXml);
+    RUN_TEST(tr, TestPullParser);
+    RUN_TEST(tr, TestPullParserQuotesAndComments);
+    RUN_TEST(tr, TestForEachSpendingInXml);
+    RUN_TEST(tr, TestTypedAttributeValue);
 }
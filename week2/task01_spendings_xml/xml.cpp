@@ -59,9 +59,30 @@ Document Load(istream& input) {
   return Document{LoadNode(input)};
 }
 
+// the number the whole text is, if any
+template <typename T>
+optional<T> ParseWhole(string_view text) {
+  T value{};
+  const auto [end, ec] = from_chars(text.data(), text.data() + text.size(), value);
+  if (text.empty() || ec != errc() || end != text.data() + text.size()) {
+    return nullopt;
+  }
+  return value;
+}
+
 Node::Node(
   string name, unordered_map<string, string> attrs
-) : name(move(name)), attrs(move(attrs)) {
+) : name(move(name)) {
+  this->attrs.reserve(attrs.size());
+  for (auto& [attr_name, text] : attrs) {
+    Attribute attr{move(text), nullopt, nullopt};
+    attr.as_integer = ParseWhole<long long>(attr.text);
+    // "inf" and "nan" are left to istream, which does not accept them
+    if (attr.text.find_first_not_of("0123456789-.eE") == string::npos) {
+      attr.as_floating = ParseWhole<double>(attr.text);
+    }
+    this->attrs.emplace(attr_name, move(attr));
+  }
 }
 
 const vector<Node>& Node::Children() const {
@@ -83,3 +104,103 @@ string_view Node::Name() const {
   return name;
 }
 
+PullParser::PullParser(string_view input) : input(input) {
+}
+
+// position of the '>' closing the tag that starts before pos, the ones inside quoted attribute values skipped
+size_t FindTagEnd(string_view input, size_t pos) {
+  for (char quote = 0; pos < input.size(); ++pos) {
+    if (quote) {
+      if (input[pos] == quote) {
+        quote = 0;
+      }
+    } else if (input[pos] == '"' || input[pos] == '\'') {
+      quote = input[pos];
+    } else if (input[pos] == '>') {
+      return pos;
+    }
+  }
+  return string_view::npos;
+}
+
+PullParser::Event PullParser::Next() {
+  if (is_pending_end) {
+    is_pending_end = false;
+    attrs = {};
+    return Event::EndElement;
+  }
+
+  while (true) {
+    const size_t tag_begin = input.find('<');
+    const bool is_comment = tag_begin != string_view::npos && input.substr(tag_begin, 4) == "<!--";
+    const size_t tag_end = is_comment ? input.find("-->", tag_begin + 4) : FindTagEnd(input, tag_begin + 1);
+    if (tag_begin == string_view::npos || tag_end == string_view::npos) {
+      input = {};
+      return Event::EndDocument;
+    }
+    if (is_comment) {
+      input.remove_prefix(tag_end + 3);
+      continue;
+    }
+    string_view tag = input.substr(tag_begin + 1, tag_end - tag_begin - 1);
+    input.remove_prefix(tag_end + 1);
+
+    if (tag.empty() || tag.front() == '?' || tag.front() == '!') {
+      continue;
+    }
+    if (tag.front() == '/') {
+      tag.remove_prefix(1);
+      name = tag.substr(0, tag.find_first_of(" \t\r\n"));
+      attrs = {};
+      return Event::EndElement;
+    }
+
+    is_pending_end = tag.back() == '/';
+    if (is_pending_end) {
+      tag.remove_suffix(1);
+    }
+    const size_t name_end = min(tag.find_first_of(" \t\r\n"), tag.size());
+    name = tag.substr(0, name_end);
+    attrs = tag.substr(name_end);
+    return Event::StartElement;
+  }
+}
+
+string_view PullParser::Name() const {
+  return name;
+}
+
+optional<string_view> PullParser::Attribute(string_view attr_name) const {
+  string_view rest = attrs;
+  while (true) {
+    rest = Lstrip(rest);
+    const size_t eq_pos = rest.find('=');
+    if (eq_pos == string_view::npos) {
+      return nullopt;
+    }
+    string_view current_name = rest.substr(0, eq_pos);
+    while (!current_name.empty() && isspace(current_name.back())) {
+      current_name.remove_suffix(1);
+    }
+
+    rest = Lstrip(rest.substr(eq_pos + 1));
+    if (rest.empty()) {
+      return nullopt;
+    }
+    string_view value;
+    if (rest.front() == '"' || rest.front() == '\'') {
+      const size_t value_end = rest.find(rest.front(), 1);
+      if (value_end == string_view::npos) {
+        return nullopt;
+      }
+      value = rest.substr(1, value_end - 1);
+      rest.remove_prefix(value_end + 1);
+    } else {  // unquoted
+      value = rest.substr(0, rest.find_first_of(" \t\r\n"));
+      rest.remove_prefix(value.size());
+    }
+    if (current_name == attr_name) {
+      return value;
+    }
+  }
+}
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <charconv>
 #include <istream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
 #include <sstream>
 #include <vector>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 using namespace std;
 
@@ -20,9 +25,16 @@ public:
   T AttributeValue(const string& name) const;
 
 private:
+  // numeric forms are parsed once in the constructor, when the whole text is a number
+  struct Attribute {
+    string text;
+    optional<long long> as_integer;
+    optional<double> as_floating;
+  };
+
   string name;
   vector<Node> children;
-  unordered_map<string, string> attrs;
+  unordered_map<string, Attribute> attrs;
 };
 
 class Document {
@@ -37,14 +49,92 @@ private:
 
 Document Load(istream& input);
 
+// StAX-style reader over a memory buffer: Next() moves to the next tag and no tree is built.
+// Names and attributes are string_views into the buffer, valid while it lives.
+// Self-closing tags produce a start event followed by an end event; text, comments and
+// declarations are skipped.
+class PullParser {
+public:
+  enum class Event {
+    StartElement,
+    EndElement,
+    EndDocument
+  };
+
+  explicit PullParser(string_view input);
+
+  Event Next();
+
+  // name of the element of the current start or end event
+  string_view Name() const;
+
+  // raw value of an attribute of the current start element
+  optional<string_view> Attribute(string_view name) const;
+
+  // value of an attribute of the current start element, numbers are converted with from_chars;
+  // throws invalid_argument if the whole value is not a number of type T
+  template <typename T>
+  T AttributeValue(string_view name) const;
+
+private:
+  string_view input;
+  string_view name;
+  string_view attrs;  // text between the name and the end of the current start tag
+  bool is_pending_end = false;  // the current start tag is self-closing
+};
+
 
 
 
+template <typename T>
+inline bool FitsInto(long long value) {
+  if constexpr (is_signed_v<T>) {
+    return value >= numeric_limits<T>::min() && value <= numeric_limits<T>::max();
+  } else {
+    return value >= 0 && static_cast<unsigned long long>(value) <= numeric_limits<T>::max();
+  }
+}
+
 template <typename T>
 inline T Node::AttributeValue(const string& name) const {
-  istringstream attr_input(attrs.at(name));
+  const Attribute& attr = attrs.at(name);
+  if constexpr (is_same_v<T, string>) {
+    return attr.text;
+  } else if constexpr (is_integral_v<T> && !is_same_v<T, bool>) {
+    if (attr.as_integer && FitsInto<T>(*attr.as_integer)) {
+      return static_cast<T>(*attr.as_integer);
+    }
+  } else if constexpr (is_floating_point_v<T>) {
+    if (attr.as_floating) {
+      return static_cast<T>(*attr.as_floating);
+    }
+  }
+
+  // anything else is read as before, so partly numeric texts give the same results
+  istringstream attr_input(attr.text);
   T result;
   attr_input >> result;
   return result;
 }
 
+template <typename T>
+inline T PullParser::AttributeValue(string_view name) const {
+  const optional<string_view> value = Attribute(name);
+  if (!value) {
+    throw out_of_range("no attribute " + string(name));
+  }
+
+  if constexpr (is_same_v<T, string_view>) {
+    return *value;
+  } else if constexpr (is_same_v<T, string>) {
+    return string(*value);
+  } else {
+    static_assert(is_arithmetic_v<T>);
+    T result{};
+    const auto [end, ec] = from_chars(value->data(), value->data() + value->size(), result);
+    if (value->empty() || ec != errc() || end != value->data() + value->size()) {
+      throw invalid_argument("attribute " + string(name) + " is not a number: " + string(*value));
+    }
+    return result;
+  }
+}
@@ -101,3 +101,14 @@ Document Load(istream& input) {
   return Document{LoadNode(input)};
 }
 
+void ForEachArrayElement(istream& input, const function<void(const Node&)>& callback) {
+  char c;
+  input >> c;  // '['
+
+  for (; input >> c && c != ']'; ) {
+    if (c != ',') {
+      input.putback(c);
+    }
+    callback(LoadNode(input));
+  }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <istream>
 #include <vector>
 #include <string>
@@ -38,3 +39,6 @@ private:
 
 Document Load(istream& input);
 
+// Reads a top-level array one element at a time: each element is loaded, passed to callback and dropped,
+// so memory is bounded by the largest element rather than by the whole array
+void ForEachArrayElement(istream& input, const function<void(const Node&)>& callback);
@@ -1,9 +1,19 @@
 #include "json.h"
+#include "spendings_aggregate.h"
 #include "test_runner.h"
 
 #include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 using namespace std;
 
@@ -41,18 +51,218 @@ string MostExpensiveCategory(
     compare_by_amount)->category;
 }
 
+// Calls callback for each spending of a JSON array, without loading the whole document
+template <typename Callback>
+void ForEachSpendingInJson(istream& input, Callback callback) {
+  ForEachArrayElement(input, [&callback](const Node& node) {
+    callback(Spending{node.AsMap().at("category").AsString(), node.AsMap().at("amount").AsInt()});
+  });
+}
+
 vector<Spending> LoadFromJson(istream& input) {
-        vector<Spending> res;
+  vector<Spending> res;
+  ForEachSpendingInJson(input, [&res](Spending spending) {
+    res.push_back(move(spending));
+  });
+  return res;
+}
+
+struct SpendingsSummary {
+  int total = 0;
+  optional<Spending> most_expensive;  // the first one among equally expensive, as in MostExpensiveCategory
+};
+
+// CalculateTotalSpendings and MostExpensiveCategory in one pass over the input, at constant memory
+SpendingsSummary SummarizeSpendingsJson(istream& input) {
+  SpendingsSummary res;
+  ForEachSpendingInJson(input, [&res](Spending spending) {
+    res.total += spending.amount;
+    if (!res.most_expensive || res.most_expensive->amount < spending.amount) {
+      res.most_expensive = move(spending);
+    }
+  });
+  return res;
+}
+
+// Raw text of the JSON string whose opening quote is right before pos, pos is moved past its closing quote.
+// Escapes are kept as they are, see UnescapeJsonString.
+string_view NextJsonString(string_view text, size_t& pos) {
+  const size_t string_begin = pos;
+  while (true) {
+    pos = text.find_first_of("\"\\", pos);
+    if (pos == string_view::npos) {
+      throw invalid_argument("unterminated JSON string: " + string(text.substr(string_begin - 1, 32)));
+    }
+    if (text[pos] == '"') {
+      ++pos;
+      return text.substr(string_begin, pos - 1 - string_begin);
+    }
+    pos += 2;  // the backslash and the escaped character
+  }
+}
+
+uint32_t ParseHex4(string_view text) {
+  uint32_t res = 0;
+  const auto [hex_end, ec] = from_chars(text.data(), text.data() + min<size_t>(text.size(), 4), res, 16);
+  if (ec != errc() || hex_end != text.data() + 4) {
+    throw invalid_argument("bad \\u escape: " + string(text.substr(0, 4)));
+  }
+  return res;
+}
 
-        Document root_doc = Load(input);
-        transform(root_doc.GetRoot().AsArray().begin(),
-                  root_doc.GetRoot().AsArray().end(),
-                  back_inserter(res),
-                  [](const Node &node) {
-                      return Spending{node.AsMap().at("category").AsString(), node.AsMap().at("amount").AsInt()};
-                  });
-        return res;
+void AppendUtf8(uint32_t code_point, string& output) {
+  if (code_point < 0x80) {
+    output += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    output += static_cast<char>(0xC0 | (code_point >> 6));
+    output += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    output += static_cast<char>(0xE0 | (code_point >> 12));
+    output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    output += static_cast<char>(0xF0 | (code_point >> 18));
+    output += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
 
+// Text of a raw JSON string as returned by NextJsonString, into output
+void UnescapeJsonString(string_view raw, string& output) {
+  output.clear();
+  for (size_t i = 0; i < raw.size(); ++i) {
+    if (raw[i] != '\\') {
+      output += raw[i];
+      continue;
+    }
+    switch (raw[++i]) {  // NextJsonString leaves no backslash at the end
+      case '"': case '\\': case '/': output += raw[i]; break;
+      case 'b': output += '\b'; break;
+      case 'f': output += '\f'; break;
+      case 'n': output += '\n'; break;
+      case 'r': output += '\r'; break;
+      case 't': output += '\t'; break;
+      case 'u': {
+        uint32_t code_point = ParseHex4(raw.substr(i + 1));
+        i += 4;
+        // a character outside the basic plane comes as a surrogate pair
+        if (code_point >= 0xD800 && code_point < 0xDC00 && raw.substr(i + 1, 2) == "\\u") {
+          const uint32_t low = ParseHex4(raw.substr(i + 3));
+          if (low >= 0xDC00 && low < 0xE000) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            i += 6;
+          }
+        }
+        AppendUtf8(code_point, output);
+        break;
+      }
+      default:
+        throw invalid_argument("bad escape in JSON string: " + string(raw));
+    }
+  }
+}
+
+size_t SkipJsonSpaces(string_view text, size_t pos) {
+  while (pos < text.size() && isspace(static_cast<unsigned char>(text[pos]))) {
+    ++pos;
+  }
+  return pos;
+}
+
+// Scans the objects of a spendings array in a part of its text, which must start and end between objects,
+// see the part ends in AggregateSpendingsJson. Objects are expected to be flat: their values are strings
+// and integers, escapes in strings included. Throws invalid_argument for anything else, so for every way
+// of splitting the text the first malformed object makes the whole aggregation throw.
+void ForEachSpendingInJsonChunk(string_view chunk, const function<void(string_view, int)>& callback) {
+  string category;
+  for (size_t pos = 0; (pos = chunk.find_first_not_of(" \t\r\n,[]", pos)) != string_view::npos; ) {
+    if (chunk[pos] != '{') {
+      throw invalid_argument("spending object expected: " + string(chunk.substr(pos, 32)));
+    }
+    category.clear();
+    int amount = 0;
+
+    pos = SkipJsonSpaces(chunk, pos + 1);
+    while (pos < chunk.size() && chunk[pos] != '}') {
+      if (chunk[pos] != '"') {
+        throw invalid_argument("key expected in spending object: " + string(chunk.substr(pos, 32)));
+      }
+      const string_view key = NextJsonString(chunk, ++pos);
+      pos = SkipJsonSpaces(chunk, pos);
+      if (pos == chunk.size() || chunk[pos] != ':') {
+        throw invalid_argument("value expected for key " + string(key));
+      }
+      pos = SkipJsonSpaces(chunk, pos + 1);
+
+      if (pos < chunk.size() && chunk[pos] == '"') {
+        const string_view value = NextJsonString(chunk, ++pos);
+        if (key == "category") {
+          UnescapeJsonString(value, category);
+        }
+      } else {
+        int value = 0;
+        const auto [value_end, ec] = from_chars(chunk.data() + pos, chunk.data() + chunk.size(), value);
+        if (ec != errc()) {
+          throw invalid_argument("string or integer expected for key " + string(key));
+        }
+        if (key == "amount") {
+          amount = value;
+        }
+        pos = value_end - chunk.data();
+      }
+
+      pos = SkipJsonSpaces(chunk, pos);
+      if (pos < chunk.size() && chunk[pos] == ',') {
+        pos = SkipJsonSpaces(chunk, pos + 1);
+      } else if (pos < chunk.size() && chunk[pos] != '}') {
+        throw invalid_argument("',' or '}' expected after key " + string(key));
+      }
+    }
+    if (pos == chunk.size()) {
+      throw invalid_argument("unterminated spending object");
+    }
+    ++pos;
+    callback(category, amount);
+  }
+}
+
+// Aggregates a spendings array in parallel parts split at object boundaries, see AggregateSpendingsInParts.
+// A part ends after the first '}' outside a string. Whether a position is inside a string depends on all
+// the text before it, so the part ends are found by one pass over the input that goes on from the previous
+// part end while the parts before are already being aggregated.
+SpendingsAggregate<Spending> AggregateSpendingsJson(string_view input, size_t top_k, size_t chunk_count) {
+  return AggregateSpendingsInParts<Spending>(
+    input, top_k, chunk_count,
+    [scanned = size_t(0), in_string = false](string_view text, size_t pos) mutable {
+      while (true) {
+        if (in_string) {
+          scanned = text.find_first_of("\"\\", scanned);
+          if (scanned == string_view::npos) {
+            return scanned = text.size();
+          }
+          if (text[scanned] == '\\') {
+            scanned += 2;
+            continue;
+          }
+          in_string = false;
+          ++scanned;
+        } else {
+          const size_t next = text.find_first_of("\"}", scanned);
+          if (next == string_view::npos) {
+            return scanned = text.size();
+          }
+          scanned = next + 1;
+          if (text[next] == '"') {
+            in_string = true;
+          } else if (next >= pos) {
+            return scanned;
+          }
+        }
+      }
+    },
+    ForEachSpendingInJsonChunk
+  );
 }
 
 void TestLoadFromJson() {
@@ -78,6 +288,100 @@ void TestLoadFromJson() {
   ASSERT_EQUAL(spendings, expected);
 }
 
+void TestSummarizeSpendingsJson() {
+  istringstream json_input(R"([
+    {"amount": 2500, "category": "food"},
+    {"amount": 23740, "category": "travel"},
+    {"amount": 1150, "category": "transport"},
+    {"amount": 23740, "category": "vacation"}
+  ])");
+
+  const SpendingsSummary summary = SummarizeSpendingsJson(json_input);
+  ASSERT_EQUAL(summary.total, 51130);
+  ASSERT(summary.most_expensive.has_value());
+  ASSERT_EQUAL(summary.most_expensive->category, "travel");
+
+  istringstream empty_input("[]");
+  const SpendingsSummary empty_summary = SummarizeSpendingsJson(empty_input);
+  ASSERT_EQUAL(empty_summary.total, 0);
+  ASSERT(!empty_summary.most_expensive.has_value());
+}
+
+void TestAggregateSpendingsJson() {
+  // keys come in either order, some objects span several lines and some have keys that are not aggregated,
+  // quotes and braces inside strings are not object boundaries
+  const vector<string> categories = {"food", "transport", "restaurants", "clothes", "travel", "sport", "gifts \"{}\""};
+  const vector<string> category_texts = {"food", "transport", "restaurants", "clothes", "travel", "sport", "gifts \\\"{}\\u0022"};
+  ostringstream json_output;
+  vector<Spending> spendings;
+  json_output << "[";
+  for (int i = 0; i < 600; ++i) {
+    spendings.push_back({categories[i % categories.size()], (i * 389) % 2000 - 100});
+    const Spending& s = spendings.back();
+    json_output << (i ? "," : "") << (i % 3 ? " " : "\n  ");
+    if (i % 2) {
+      json_output << R"({"category": ")" << category_texts[i % categories.size()] << R"(", "amount": )" << s.amount << "}";
+    } else {
+      json_output << "{\n    \"amount\":" << s.amount << ",\n    \"note\": \"paid: cash, change} {\\\"amount\\\": 1}\\\\\",\n"
+                  << "    \"category\" : \"" << category_texts[i % categories.size()] << "\"\n  }";
+    }
+  }
+  json_output << "\n]";
+  const string json_input = json_output.str();
+
+  map<string, int64_t, less<>> expected_category_totals;
+  for (const Spending& s : spendings) {
+    expected_category_totals[s.category] += s.amount;
+  }
+  vector<Spending> expected_top = spendings;
+  stable_sort(begin(expected_top), end(expected_top), [](const Spending& lhs, const Spending& rhs) {
+    return lhs.amount > rhs.amount;
+  });
+  expected_top.resize(5);
+
+  for (size_t chunk_count : {1, 2, 3, 8, 5000}) {
+    const SpendingsAggregate<Spending> aggregate = AggregateSpendingsJson(json_input, 5, chunk_count);
+    ASSERT_EQUAL(aggregate.total, CalculateTotalSpendings(spendings));
+    ASSERT(aggregate.category_totals == expected_category_totals);
+    ASSERT_EQUAL(aggregate.top, expected_top);
+    ASSERT_EQUAL(aggregate.top.front().category, MostExpensiveCategory(spendings));
+  }
+
+  const SpendingsAggregate<Spending> empty_aggregate = AggregateSpendingsJson("[]", 5, 4);
+  ASSERT_EQUAL(empty_aggregate.total, 0);
+  ASSERT(empty_aggregate.top.empty());
+}
+
+void TestAggregateSpendingsJsonMalformed() {
+  // a malformed object makes the aggregation throw, wherever the input is split
+  ostringstream valid_output;
+  for (int i = 0; i < 300; ++i) {
+    valid_output << R"({"category": "food", "amount": )" << i << "}, ";
+  }
+  const string valid = valid_output.str();
+
+  for (const string malformed : {
+    R"({"a"})",
+    R"({"category": "x}, {"amount": 7})",
+    R"({"category": "food", "amount": true})",
+    R"({"category": "food", "amount": 1.5})",
+    R"({"category": "food" "amount": 5})",
+    R"({"category": "f\q", "amount": 5})",
+    R"({"amount": 5, "category": "food")",
+  }) {
+    const string json_input = "[" + valid + malformed + ", " + valid + R"({"category": "food", "amount": 1}])";
+    for (size_t chunk_count : {1, 2, 3, 8, 5000}) {
+      bool is_thrown = false;
+      try {
+        AggregateSpendingsJson(json_input, 5, chunk_count);
+      } catch (const invalid_argument&) {
+        is_thrown = true;
+      }
+      Assert(is_thrown, malformed + ", chunk_count = " + to_string(chunk_count));
+    }
+  }
+}
+
 void TestJsonLibrary() {
   // Тест демонстрирует, как пользоваться библиотекой из файла json.h
 
@@ -108,4 +412,7 @@ int main() {
   TestRunner tr;
   RUN_TEST(tr, TestJsonLibrary);
   RUN_TEST(tr, TestLoadFromJson);
+  RUN_TEST(tr, TestSummarizeSpendingsJson);
+  RUN_TEST(tr, TestAggregateSpendingsJson);
+  RUN_TEST(tr, TestAggregateSpendingsJsonMalformed);
 }
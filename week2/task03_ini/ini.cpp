@@ -1,5 +1,9 @@
+#include <fstream>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 using namespace std;
@@ -37,4 +41,156 @@ namespace Ini {
         }
         return res;
     }
+
+
+    ReloadableDocument::ReloadableDocument(string path) : path(move(path)) {
+        if (!ReloadIfChanged()) {
+            throw runtime_error("can't open " + this->path);
+        }
+    }
+
+    ReloadableDocument::~ReloadableDocument() {
+        StopWatching();
+        delete current.load();
+    }
+
+    shared_ptr<const Document> ReloadableDocument::Get() const {
+        atomic<size_t> &active = active_gets[get_epoch.load() % 2];
+        ++active;
+        shared_ptr<const Document> res = *current.load();
+        --active;
+        return res;
+    }
+
+    size_t ReloadableDocument::Version() const {
+        return version.load();
+    }
+
+    bool ReloadableDocument::ReloadIfChanged() {
+        lock_guard<mutex> guard(reload_mutex);
+
+        ifstream input(path);
+        if (!input) {
+            return false;
+        }
+        ostringstream text_output;
+        text_output << input.rdbuf();
+        const string text = text_output.str();
+        const size_t text_hash = hash<string>{}(text);
+        if (text_hash == loaded_hash) {
+            return false;
+        }
+
+        istringstream text_input(text);
+        auto new_document = make_unique<const shared_ptr<const Document>>(make_shared<Document>(Load(text_input)));
+        const shared_ptr<const Document> *old_document = current.exchange(new_document.release());
+        if (old_document) {
+            WaitForGets();
+            delete old_document;  // readers that copied the shared_ptr keep the version itself
+        }
+        loaded_hash = text_hash;
+        ++version;
+        return true;
+    }
+
+    void ReloadableDocument::WaitForGets() {
+        // Every Get is counted in one of active_gets while it reads current. One counted after the check of its
+        // counter below loads current after the exchange and can't see the old holder, one counted before is
+        // waited for. New Gets are switched to the other counter before each check, so they can't keep it busy.
+        for (int phase = 0; phase < 2; ++phase) {
+            const size_t parity = get_epoch++ % 2;
+            while (active_gets[parity].load() != 0) {
+                this_thread::yield();
+            }
+        }
+    }
+
+    void ReloadableDocument::StartWatching(chrono::milliseconds period) {
+        StopWatching();
+        {
+            lock_guard<mutex> guard(watch_mutex);
+            stop_requested = false;
+        }
+        watcher = thread([this, period] {
+            unique_lock<mutex> lock(watch_mutex);
+            while (!watch_stop.wait_for(lock, period, [this] { return stop_requested; })) {
+                lock.unlock();
+                ReloadIfChanged();
+                lock.lock();
+            }
+        });
+    }
+
+    void ReloadableDocument::StopWatching() {
+        {
+            lock_guard<mutex> guard(watch_mutex);
+            stop_requested = true;
+        }
+        watch_stop.notify_all();
+        if (watcher.joinable()) {
+            watcher.join();
+        }
+    }
+
+
+    FlatDocument::FlatDocument(string text) : buffer(make_unique<const string>(move(text))) {
+        struct Entry {
+            size_t section_id;
+            string_view key;
+            string_view value;
+        };
+        vector<Entry> entries;
+        vector<size_t> section_sizes;
+        optional<size_t> current_section_id;
+
+        // entries are collected first, so every table is sized once instead of growing
+        string_view rest = *buffer;
+        while (!rest.empty()) {
+            const size_t line_end = min(rest.find('\n'), rest.size());
+            const string_view line = rest.substr(0, line_end);
+            rest.remove_prefix(min(line_end + 1, rest.size()));
+
+            if (line.empty()) { continue; }
+            if (line[0] == '[') {
+                size_t bracket_pos = line.rfind(']');
+                current_section_id = section_ids.Insert(line.substr(1, bracket_pos - 1), section_sizes.size());
+                if (*current_section_id == section_sizes.size()) {
+                    section_sizes.push_back(0);
+                }
+            } else if (current_section_id) {
+                size_t equal_pos = min(line.find('='), line.size());
+                entries.push_back({*current_section_id, line.substr(0, equal_pos), line.substr(min(equal_pos + 1, line.size()))});
+                ++section_sizes[*current_section_id];
+            }
+        }
+
+        sections.resize(section_sizes.size());
+        for (size_t section_id = 0; section_id < sections.size(); ++section_id) {
+            sections[section_id].Reserve(section_sizes[section_id]);
+        }
+        for (const Entry &entry : entries) {
+            sections[entry.section_id].Insert(entry.key, entry.value);
+        }
+    }
+
+    const FlatSection &FlatDocument::GetSection(string_view name) const {
+        const size_t *section_id = section_ids.Find(name);
+        if (!section_id) {
+            throw out_of_range("unknown section " + string(name));
+        }
+        return sections[*section_id];
+    }
+
+    size_t FlatDocument::SectionCount() const {
+        return sections.size();
+    }
+
+    FlatDocument LoadFlat(istream &input) {
+        string text;
+        char chunk[1 << 16];
+        while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+            text.append(chunk, static_cast<size_t>(input.gcount()));
+        }
+        return FlatDocument(move(text));
+    }
 }
\ No newline at end of file
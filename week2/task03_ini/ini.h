@@ -1,8 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 using namespace std;
 
@@ -22,4 +35,173 @@ namespace Ini {
     };
 
     Document Load(istream &input);
+
+
+    // Latest version of an INI file. A reload parses the file without holding anything readers need and then
+    // publishes the new immutable document with one atomic exchange. Get is wait-free: it takes no lock, neither
+    // the reload one nor the lock pool behind atomic_load of a shared_ptr, only a few atomic operations.
+    // A version stays valid for as long as someone holds its pointer, even after newer ones are published.
+    class ReloadableDocument {
+    public:
+        // loads the file right away, throws runtime_error if it can't be opened
+        explicit ReloadableDocument(string path);
+
+        ~ReloadableDocument();
+
+        shared_ptr<const Document> Get() const;
+
+        // number of versions published so far, the initial load included
+        size_t Version() const;
+
+        // reads the file and parses it again if its content hash differs from the loaded one, returns whether it did.
+        // The content is compared rather than the modification time, which misses a rewrite of the same size
+        // within the timestamp granularity. If the file can't be opened the current version is kept.
+        // A file rewritten in place may be caught half-written, so writers should replace it with a rename.
+        bool ReloadIfChanged();
+
+        // calls ReloadIfChanged every period on a background thread until StopWatching or destruction
+        void StartWatching(chrono::milliseconds period);
+
+        void StopWatching();
+
+    private:
+        const string path;
+        // Owned holder of the current version, immutable once published. Get copies the shared_ptr out of it,
+        // so a replaced holder is deleted only after the Get calls that could have loaded it are over.
+        atomic<const shared_ptr<const Document> *> current = nullptr;
+        // Get calls in progress, counted by the parity of get_epoch they started with, see WaitForGets
+        mutable array<atomic<size_t>, 2> active_gets = {};
+        atomic<size_t> get_epoch = 0;
+        atomic<size_t> version = 0;
+
+        mutex reload_mutex;  // serializes reloads, never taken by readers
+        optional<size_t> loaded_hash;  // of the text the current version was parsed from
+
+        mutex watch_mutex;
+        condition_variable watch_stop;
+        bool stop_requested = false;
+        thread watcher;
+
+        // Returns once every Get that started before the call is over. Gets are a few instructions long,
+        // so this spins briefly, and only reloads ever wait.
+        void WaitForGets();
+    };
+
+
+    // Open addressing table with linear probing over string_view keys, which must outlive it.
+    // Elements are stored densely in insertion order and the probed slots hold only their indexes,
+    // so the table stays small and is rebuilt without moving the elements.
+    // Inserting a key that is already there keeps the first value, like Section::insert.
+    template<typename Value>
+    class FlatTable {
+    public:
+        Value &Insert(string_view key, Value value);
+
+        // makes room for size elements without further rehashing
+        void Reserve(size_t size);
+
+        const Value *Find(string_view key) const;
+
+        size_t Size() const { return elements.size(); }
+
+    private:
+        struct Element {
+            string_view key;
+            Value value;
+            size_t key_hash;
+        };
+
+        static constexpr uint32_t EMPTY_SLOT = 0;  // other slots hold element index + 1
+
+        vector<Element> elements;
+        vector<uint32_t> slots;
+
+        // of the key, or of the empty slot where it would go
+        size_t SlotIndex(string_view key, size_t key_hash) const;
+
+        void Rehash(size_t slot_count);
+    };
+
+    using FlatSection = FlatTable<string_view>;
+
+    // Read-only document over one owned buffer: section names, keys and values are string_views into it,
+    // so loading allocates only the tables and not a string per entry
+    class FlatDocument {
+    public:
+        explicit FlatDocument(string text);
+
+        const FlatSection &GetSection(string_view name) const;  // throws out_of_range for unknown section
+
+        size_t SectionCount() const;
+
+    private:
+        unique_ptr<const string> buffer;  // on the heap, so moving the document keeps the views valid
+        FlatTable<size_t> section_ids;
+        vector<FlatSection> sections;
+    };
+
+    FlatDocument LoadFlat(istream &input);
+
+
+    template<typename Value>
+    Value &FlatTable<Value>::Insert(string_view key, Value value) {
+        if (2 * (elements.size() + 1) > slots.size()) {
+            Rehash(max<size_t>(8, slots.size() * 2));
+        }
+        const size_t key_hash = hash<string_view>{}(key);
+        uint32_t &slot = slots[SlotIndex(key, key_hash)];
+        if (slot == EMPTY_SLOT) {
+            elements.push_back({key, move(value), key_hash});
+            slot = static_cast<uint32_t>(elements.size());
+        }
+        return elements[slot - 1].value;
+    }
+
+    template<typename Value>
+    void FlatTable<Value>::Reserve(size_t size) {
+        elements.reserve(size);
+        size_t slot_count = 8;
+        while (slot_count < 2 * size) {
+            slot_count *= 2;
+        }
+        if (slot_count > slots.size()) {
+            Rehash(slot_count);
+        }
+    }
+
+    template<typename Value>
+    const Value *FlatTable<Value>::Find(string_view key) const {
+        if (slots.empty()) {
+            return nullptr;
+        }
+        const uint32_t slot = slots[SlotIndex(key, hash<string_view>{}(key))];
+        return slot == EMPTY_SLOT ? nullptr : &elements[slot - 1].value;
+    }
+
+    template<typename Value>
+    size_t FlatTable<Value>::SlotIndex(string_view key, size_t key_hash) const {
+        const size_t mask = slots.size() - 1;  // the size is a power of two
+        size_t idx = key_hash & mask;
+        while (slots[idx] != EMPTY_SLOT) {
+            const Element &element = elements[slots[idx] - 1];
+            if (element.key_hash == key_hash && element.key == key) {
+                break;
+            }
+            idx = (idx + 1) & mask;
+        }
+        return idx;
+    }
+
+    template<typename Value>
+    void FlatTable<Value>::Rehash(size_t slot_count) {
+        slots.assign(slot_count, EMPTY_SLOT);
+        const size_t mask = slot_count - 1;
+        for (size_t element_idx = 0; element_idx < elements.size(); ++element_idx) {
+            size_t idx = elements[element_idx].key_hash & mask;
+            while (slots[idx] != EMPTY_SLOT) {
+                idx = (idx + 1) & mask;
+            }
+            slots[idx] = static_cast<uint32_t>(element_idx + 1);
+        }
+    }
 }
\ No newline at end of file
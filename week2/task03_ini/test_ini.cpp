@@ -2,7 +2,12 @@
 
 #include "ini.h"
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
 #include <sstream>
+#include <thread>
 
 using namespace std;
 
@@ -126,6 +131,185 @@ void TestDuplicateSections() {
     ASSERT_EQUAL(doc.GetSection("one"), expected);
 }
 
+void AssertFlatSectionEqual(const Ini::FlatSection &section, const Ini::Section &expected) {
+    ASSERT_EQUAL(section.Size(), expected.size());
+    for (const auto &[key, value] : expected) {
+        const string_view *flat_value = section.Find(key);
+        ASSERT(flat_value != nullptr);
+        ASSERT_EQUAL(*flat_value, value);
+    }
+}
+
+void TestLoadFlatIni() {
+    istringstream input(
+            R"([july]
+food=2500
+sport=12000
+travel=23400
+
+[august]
+food=3250
+jewelery=25000
+food=1
+
+[july]
+clothes=5200
+)"
+    );
+
+    const Ini::FlatDocument doc = Ini::LoadFlat(input);
+
+    ASSERT_EQUAL(doc.SectionCount(), 2u);
+    AssertFlatSectionEqual(doc.GetSection("july"), {
+            {"food",    "2500"},
+            {"sport",   "12000"},
+            {"travel",  "23400"},
+            {"clothes", "5200"},
+    });
+    AssertFlatSectionEqual(doc.GetSection("august"), {
+            {"food",     "3250"},
+            {"jewelery", "25000"},
+    });
+    ASSERT(doc.GetSection("august").Find("sport") == nullptr);
+
+    try {
+        doc.GetSection("september");
+        Assert(false, "Ini::FlatDocument::GetSection() should throw std::out_of_range for unknown section");
+    } catch (out_of_range &) {
+    }
+}
+
+void TestLoadFlatIniMatchesLoad() {
+    ostringstream output;
+    for (int section = 0; section < 50; ++section) {
+        output << "[section" << section << "]\n";
+        for (int key = 0; key < 200; ++key) {
+            output << "key" << key * 7 % 190 << "=value" << section * key << "\n";
+        }
+    }
+
+    istringstream input(output.str());
+    const Ini::Document doc = Ini::Load(input);
+    Ini::FlatDocument flat_doc(output.str());
+    // moving the document must keep its views valid
+    const Ini::FlatDocument moved_flat_doc = move(flat_doc);
+
+    ASSERT_EQUAL(moved_flat_doc.SectionCount(), doc.SectionCount());
+    for (int section = 0; section < 50; ++section) {
+        const string name = "section" + to_string(section);
+        AssertFlatSectionEqual(moved_flat_doc.GetSection(name), doc.GetSection(name));
+    }
+}
+
+// a path in the temp directory that no other run of the tests uses at the same time
+filesystem::path UniqueTempPath(const string &name) {
+    random_device random;
+    filesystem::path res;
+    do {
+        res = filesystem::temp_directory_path() / (name + "_" + to_string(random()) + ".ini");
+    } while (filesystem::exists(res));
+    return res;
+}
+
+// written aside and renamed over path, so a watcher never sees a half-written file
+void WriteFile(const filesystem::path &path, const string &text) {
+    filesystem::path new_path = path;
+    new_path += ".new";
+    ofstream(new_path) << text;
+    filesystem::rename(new_path, path);
+}
+
+void TestReloadableDocument() {
+    const filesystem::path path = UniqueTempPath("test_ini_reloadable");
+    WriteFile(path, "[goods]\nsugar=1\n");
+
+    Ini::ReloadableDocument config(path.string());
+    ASSERT_EQUAL(config.Version(), 1u);
+    const shared_ptr<const Ini::Document> first = config.Get();
+    ASSERT_EQUAL(first->GetSection("goods"), Ini::Section({{"sugar", "1"}}));
+    ASSERT(!config.ReloadIfChanged());
+
+    WriteFile(path, "[goods]\nsugar=2\n");
+    ASSERT(config.ReloadIfChanged());
+    ASSERT_EQUAL(config.Version(), 2u);
+    ASSERT_EQUAL(config.Get()->GetSection("goods"), Ini::Section({{"sugar", "2"}}));
+    // the version taken before the reload is not affected
+    ASSERT_EQUAL(first->GetSection("goods"), Ini::Section({{"sugar", "1"}}));
+
+    // same size, most likely within the timestamp granularity as well: only the content tells the rewrite
+    WriteFile(path, "[goods]\nsugar=3\n");
+    ASSERT(config.ReloadIfChanged());
+    ASSERT_EQUAL(config.Version(), 3u);
+    ASSERT_EQUAL(config.Get()->GetSection("goods"), Ini::Section({{"sugar", "3"}}));
+
+    // rewriting the same content is not a new version
+    WriteFile(path, "[goods]\nsugar=3\n");
+    ASSERT(!config.ReloadIfChanged());
+    ASSERT_EQUAL(config.Version(), 3u);
+
+    // a missing file keeps the current version
+    filesystem::remove(path);
+    ASSERT(!config.ReloadIfChanged());
+    ASSERT_EQUAL(config.Get()->GetSection("goods"), Ini::Section({{"sugar", "3"}}));
+
+    try {
+        Ini::ReloadableDocument missing(path.string());
+        Assert(false, "Ini::ReloadableDocument should throw std::runtime_error for a missing file");
+    } catch (runtime_error &) {
+    }
+}
+
+void TestReloadableDocumentWatching() {
+    const filesystem::path path = UniqueTempPath("test_ini_watching");
+    WriteFile(path, "[goods]\nsugar=1\n");
+    Ini::ReloadableDocument config(path.string());
+
+    // readers keep going while versions are replaced under them, failures are reported to the main thread
+    atomic<bool> done = false;
+    atomic<bool> reader_failed = false;
+    thread reader([&config, &done, &reader_failed] {
+        while (!done) {
+            const shared_ptr<const Ini::Document> doc = config.Get();
+            try {
+                const string &sugar = doc->GetSection("goods").at("sugar");
+                if (sugar != "1" && sugar != "2") {
+                    reader_failed = true;
+                }
+            } catch (out_of_range &) {
+                reader_failed = true;
+            }
+        }
+    });
+
+    // nothing is asserted until the reader is joined, a throw would leave it joinable
+    size_t missed_reloads = 0;
+    for (int reload = 0; reload < 100; ++reload) {
+        WriteFile(path, reload % 2 == 0 ? "[goods]\nsugar=2\n" : "[goods]\nsugar=1\n");
+        if (!config.ReloadIfChanged()) {
+            ++missed_reloads;
+        }
+    }
+    const size_t reloaded_version = config.Version();
+
+    // the watcher picks up a rewrite by itself
+    WriteFile(path, "[goods]\nsugar=2\n");
+    config.StartWatching(chrono::milliseconds(1));
+    const auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+    while (config.Version() < 102 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    config.StopWatching();
+    done = true;
+    reader.join();
+
+    ASSERT(!reader_failed);
+    ASSERT_EQUAL(missed_reloads, 0u);
+    ASSERT_EQUAL(reloaded_version, 101u);
+    ASSERT_EQUAL(config.Version(), 102u);
+    ASSERT_EQUAL(config.Get()->GetSection("goods"), Ini::Section({{"sugar", "2"}}));
+    filesystem::remove(path);
+}
+
 int main() {
     TestRunner tr;
     RUN_TEST(tr, TestLoadIni);
@@ -133,5 +317,9 @@ int main() {
     RUN_TEST(tr, TestDocument);
     RUN_TEST(tr, TestUnknownSection);
     RUN_TEST(tr, TestDuplicateSections);
+    RUN_TEST(tr, TestLoadFlatIni);
+    RUN_TEST(tr, TestLoadFlatIniMatchesLoad);
+    RUN_TEST(tr, TestReloadableDocument);
+    RUN_TEST(tr, TestReloadableDocumentWatching);
     return 0;
 }
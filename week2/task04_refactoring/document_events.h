@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string_view>
+
+namespace Events {
+
+enum class EventType {
+  StartObject,
+  StartArray,
+  Key,
+  String,
+  Number,
+  End,  // closes the innermost object or array
+  EndDocument,
+};
+
+// text is a view into the buffer being read: the key for Key, the value for String and Number,
+// empty otherwise
+struct Event {
+  EventType type;
+  std::string_view text = {};
+};
+
+// Pull interface shared by the buffer-based readers of every format. A reader keeps only
+// its position and what is needed to tell the next event, so memory does not grow with the document.
+class EventReader {
+public:
+  virtual ~EventReader() = default;
+
+  // EndDocument once the buffer is over, and on every call after that
+  virtual Event Next() = 0;
+};
+
+// skips the value that starts with first, nested objects and arrays included
+inline void SkipValue(EventReader& reader, const Event& first) {
+  if (first.type != EventType::StartObject && first.type != EventType::StartArray) {
+    return;
+  }
+  for (int depth = 1; depth > 0; ) {
+    switch (reader.Next().type) {
+      case EventType::StartObject:
+      case EventType::StartArray:
+        ++depth;
+        break;
+      case EventType::End:
+        --depth;
+        break;
+      case EventType::EndDocument:
+        return;
+      default:
+        break;
+    }
+  }
+}
+
+}
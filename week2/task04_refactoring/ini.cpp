@@ -0,0 +1,61 @@
+#include "ini.h"
+
+#include <algorithm>
+using namespace std;
+
+namespace Ini {
+
+EventReader::EventReader(string_view buffer) : rest(buffer) {
+}
+
+Events::Event EventReader::Next() {
+  using Events::EventType;
+
+  if (queued_begin < queued_end) {
+    return queued[queued_begin++];
+  }
+  queued_begin = queued_end = 0;
+
+  if (!is_started) {
+    is_started = true;
+    return {EventType::StartObject};
+  }
+
+  while (!rest.empty()) {
+    const size_t line_end = min(rest.find('\n'), rest.size());
+    const string_view line = rest.substr(0, line_end);
+    rest.remove_prefix(min(line_end + 1, rest.size()));
+
+    if (line.empty()) { continue; }
+    if (line[0] == '[') {
+      if (in_section) {
+        Queue({EventType::End});
+      }
+      Queue({EventType::Key, line.substr(1, line.rfind(']') - 1)});
+      Queue({EventType::StartObject});
+      in_section = true;
+      return Next();
+    } else if (in_section) {
+      const size_t equal_pos = min(line.find('='), line.size());
+      Queue({EventType::Key, line.substr(0, equal_pos)});
+      Queue({EventType::String, line.substr(min(equal_pos + 1, line.size()))});
+      return Next();
+    }
+  }
+
+  if (in_section) {
+    in_section = false;
+    return {EventType::End};
+  }
+  if (!is_finished) {
+    is_finished = true;
+    return {EventType::End};
+  }
+  return {EventType::EndDocument};
+}
+
+void EventReader::Queue(Events::Event event) {
+  queued[queued_end++] = event;
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "document_events.h"
+
+#include <array>
+#include <string_view>
+
+namespace Ini {
+
+// Events of the Ini text in buffer (the format of task03_ini), which must outlive the reader.
+// The document is an object with a Key and an object of String values for each section,
+// so a section that appears twice is reported twice. Lines before the first section are skipped.
+class EventReader : public Events::EventReader {
+public:
+  explicit EventReader(std::string_view buffer);
+
+  Events::Event Next() override;
+
+private:
+  std::string_view rest;
+  std::array<Events::Event, 3> queued;  // a line gives up to three events
+  size_t queued_begin = 0;
+  size_t queued_end = 0;
+  bool is_started = false;
+  bool in_section = false;
+  bool is_finished = false;
+
+  void Queue(Events::Event event);
+};
+
+}
@@ -1,4 +1,8 @@
 #include "json.h"
+
+#include <cctype>
+#include <stdexcept>
+#include <string>
 using namespace std;
 
 namespace Json {
@@ -104,4 +108,137 @@ Document Load(istream& input) {
   return Document{LoadNode(input)};
 }
 
+EventReader::EventReader(string_view buffer) : rest(buffer) {
+}
+
+Events::Event EventReader::Next() {
+  using Events::EventType;
+
+  // separators carry no information the open containers do not already give
+  while (!rest.empty() && (isspace(static_cast<unsigned char>(rest.front())) || rest.front() == ',' || rest.front() == ':')) {
+    rest.remove_prefix(1);
+  }
+  if (rest.empty()) {
+    return {EventType::EndDocument};
+  }
+
+  const char c = rest.front();
+  if (c == '{' || c == '[') {
+    rest.remove_prefix(1);
+    open_is_object.push_back(c == '{');
+    expecting_key = c == '{';
+    return {c == '{' ? EventType::StartObject : EventType::StartArray};
+  }
+  if (c == '}' || c == ']') {
+    rest.remove_prefix(1);
+    if (!open_is_object.empty()) {
+      open_is_object.pop_back();
+    }
+    FinishValue();
+    return {EventType::End};
+  }
+  if (c == '"') {
+    const size_t quote_pos = min(rest.find('"', 1), rest.size());
+    const string_view text = rest.substr(1, quote_pos - 1);
+    rest.remove_prefix(min(quote_pos + 1, rest.size()));
+    if (expecting_key) {
+      expecting_key = false;
+      return {EventType::Key, text};
+    }
+    FinishValue();
+    return {EventType::String, text};
+  }
+
+  // like Load, only integers are supported besides strings and containers
+  size_t length = c == '-' ? 1 : 0;
+  while (length < rest.size() && isdigit(static_cast<unsigned char>(rest[length]))) {
+    ++length;
+  }
+  if (length == 0 || rest[length - 1] == '-') {
+    throw invalid_argument("unsupported Json token: " + string(rest.substr(0, 16)));
+  }
+  const string_view text = rest.substr(0, length);
+  rest.remove_prefix(length);
+  FinishValue();
+  return {EventType::Number, text};
+}
+
+void EventReader::FinishValue() {
+  expecting_key = !open_is_object.empty() && open_is_object.back();
+}
+
+EventWriter::EventWriter(ostream& output) : output(output) {
+}
+
+void EventWriter::Write(const Events::Event& event) {
+  using Events::EventType;
+
+  switch (event.type) {
+    case EventType::StartObject:
+    case EventType::StartArray:
+      StartValue();
+      output << (event.type == EventType::StartObject ? '{' : '[');
+      open_containers.push_back({event.type == EventType::StartObject ? '}' : ']', false});
+      break;
+    case EventType::Key:
+      if (!InObject() || after_key) {
+        throw invalid_argument("Json key outside of an object: " + string(event.text));
+      }
+      StartItem();
+      output << '"' << event.text << "\": ";
+      after_key = true;
+      break;
+    case EventType::String:
+      StartValue();
+      output << '"' << event.text << '"';
+      break;
+    case EventType::Number:
+      StartValue();
+      output << event.text;
+      break;
+    case EventType::End:
+      if (after_key) {
+        throw invalid_argument("Json key without a value");
+      }
+      if (!open_containers.empty()) {
+        output << open_containers.back().closing;
+        open_containers.pop_back();
+      }
+      break;
+    case EventType::EndDocument:
+      break;
+  }
+}
+
+bool EventWriter::InObject() const {
+  return !open_containers.empty() && open_containers.back().closing == '}';
+}
+
+void EventWriter::StartValue() {
+  if (after_key) {
+    after_key = false;
+    return;
+  }
+  if (InObject()) {
+    throw invalid_argument("Json value in an object without a key");
+  }
+  StartItem();
+}
+
+void EventWriter::StartItem() {
+  if (!open_containers.empty()) {
+    if (open_containers.back().has_items) {
+      output << ", ";
+    }
+    open_containers.back().has_items = true;
+  }
+}
+
+void WriteEvents(Events::EventReader& reader, ostream& output) {
+  EventWriter writer(output);
+  for (Events::Event event = reader.Next(); event.type != Events::EventType::EndDocument; event = reader.Next()) {
+    writer.Write(event);
+  }
+}
+
 }
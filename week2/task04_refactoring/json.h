@@ -1,6 +1,10 @@
 #pragma once
 
+#include "document_events.h"
+
 #include <istream>
+#include <ostream>
+#include <string_view>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -39,4 +43,47 @@ private:
 
 Document Load(std::istream& input);
 
+// Events of the Json text in buffer, which must outlive the reader. Accepts the same
+// subset as Load: objects, arrays, strings without escapes and integers. Next throws
+// std::invalid_argument for any other token, such as true or a fraction.
+class EventReader : public Events::EventReader {
+public:
+  explicit EventReader(std::string_view buffer);
+
+  Events::Event Next() override;
+
+private:
+  std::string_view rest;
+  std::vector<bool> open_is_object;  // innermost last
+  bool expecting_key = false;
+
+  void FinishValue();
+};
+
+// Writes events as Json text. Throws std::invalid_argument for events that do not make up Json:
+// a value in an object without a Key before it, or a Key outside of an object.
+class EventWriter {
+public:
+  explicit EventWriter(std::ostream& output);
+
+  void Write(const Events::Event& event);
+
+private:
+  struct OpenContainer {
+    char closing;
+    bool has_items;
+  };
+
+  std::ostream& output;
+  std::vector<OpenContainer> open_containers;  // innermost last
+  bool after_key = false;
+
+  bool InObject() const;
+  void StartValue();
+  void StartItem();  // a separator before all but the first item of the container
+};
+
+// streams all events of reader into output as Json text
+void WriteEvents(Events::EventReader& reader, std::ostream& output);
+
 }
@@ -1,10 +1,17 @@
+#include "document_events.h"
+#include "ini.h"
 #include "xml.h"
 #include "json.h"
 
 #include "test_runner.h"
 
+#include <charconv>
+#include <optional>
+#include <stdexcept>
 #include <vector>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <map>
 
 
@@ -34,6 +41,104 @@ Xml::Document JsonToXml(const Json::Document& doc, string root_name) {
   return Xml::Document(root);
 }
 
+// Streaming versions of the conversions above: the text is read event by event and written
+// spending by spending, without building either document
+
+// the next event of reader, which must be of the given type
+Events::Event NextOf(Events::EventReader& reader, Events::EventType type) {
+  Events::Event event = reader.Next();
+  if (event.type != type) {
+    throw invalid_argument("unexpected event after: " + string(event.text));
+  }
+  return event;
+}
+
+// skips the start of an Xml element up to its attributes, see Xml::EventReader
+void StartXmlElement(Events::EventReader& reader) {
+  NextOf(reader, Events::EventType::Key);  // the element name
+  NextOf(reader, Events::EventType::StartObject);
+  NextOf(reader, Events::EventType::Key);  // "attributes"
+  NextOf(reader, Events::EventType::StartObject);
+}
+
+void XmlToJson(string_view xml, ostream& output) {
+  using Events::EventType;
+
+  Xml::EventReader reader(xml);
+  Json::EventWriter writer(output);
+
+  NextOf(reader, EventType::StartObject);  // the root element
+  StartXmlElement(reader);
+  for (Events::Event event = reader.Next(); event.type == EventType::Key; event = reader.Next()) {
+    reader.Next();
+  }
+  NextOf(reader, EventType::Key);  // "children"
+  NextOf(reader, EventType::StartArray);
+
+  writer.Write({EventType::StartArray});
+  for (Events::Event event = reader.Next(); event.type == EventType::StartObject; event = reader.Next()) {
+    StartXmlElement(reader);
+    optional<string_view> category;
+    optional<string_view> amount;
+    for (event = reader.Next(); event.type == EventType::Key; event = reader.Next()) {
+      const string_view name = event.text;
+      const string_view value = reader.Next().text;
+      if (name == "category") {
+        category = value;
+      } else if (name == "amount") {
+        amount = value;
+      }
+    }
+    NextOf(reader, EventType::Key);  // "children"
+    Events::SkipValue(reader, NextOf(reader, EventType::StartArray));
+    NextOf(reader, EventType::End);
+    NextOf(reader, EventType::End);
+
+    // the same as Xml::Node::AttributeValue throws for the loaded document
+    if (!category || !amount) {
+      throw out_of_range("spend without category or amount");
+    }
+    int amount_value = 0;
+    const auto [amount_end, ec] = from_chars(amount->data(), amount->data() + amount->size(), amount_value);
+    if (ec != errc() || amount_end != amount->data() + amount->size()) {
+      throw invalid_argument("amount is not a number: " + string(*amount));
+    }
+
+    writer.Write({EventType::StartObject});
+    writer.Write({EventType::Key, "category"});
+    writer.Write({EventType::String, *category});
+    writer.Write({EventType::Key, "amount"});
+    writer.Write({EventType::Number, *amount});
+    writer.Write({EventType::End});
+  }
+  writer.Write({EventType::End});
+}
+
+void JsonToXml(string_view json, ostream& output, string_view root_name) {
+  using Events::EventType;
+
+  Json::EventReader reader(json);
+  reader.Next();  // the array of spendings
+
+  output << '<' << root_name << ">\n";
+  for (Events::Event event = reader.Next(); event.type == EventType::StartObject; event = reader.Next()) {
+    string_view category;
+    string_view amount;
+    for (event = reader.Next(); event.type == EventType::Key; event = reader.Next()) {
+      const string_view name = event.text;
+      const Events::Event value = reader.Next();
+      if (name == "category") {
+        category = value.text;
+      } else if (name == "amount") {
+        amount = value.text;
+      }
+      Events::SkipValue(reader, value);
+    }
+    output << "  <spend amount=\"" << amount << "\" category=\"" << category << "\"></spend>\n";
+  }
+  output << "</" << root_name << ">\n";
+}
+
 void TestXmlToJson() {
 
   Xml::Node root("july", {});
@@ -104,9 +209,243 @@ void TestJsonToXml() {
   }
 }
 
+void TestJsonEventReader() {
+  using Events::EventType;
+
+  Json::EventReader reader(R"([{"amount": 2500, "tags": ["a", "b"]}, -7])");
+  const vector<pair<EventType, string_view>> expected = {
+    {EventType::StartArray, ""}, {EventType::StartObject, ""},
+    {EventType::Key, "amount"}, {EventType::Number, "2500"},
+    {EventType::Key, "tags"}, {EventType::StartArray, ""}, {EventType::String, "a"}, {EventType::String, "b"}, {EventType::End, ""},
+    {EventType::End, ""}, {EventType::Number, "-7"}, {EventType::End, ""},
+    {EventType::EndDocument, ""}, {EventType::EndDocument, ""},
+  };
+
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const Events::Event event = reader.Next();
+    const string feedback_msg = "i = " + to_string(i);
+    Assert(event.type == expected[i].first, feedback_msg);
+    AssertEqual(event.text, expected[i].second, feedback_msg);
+  }
+}
+
+void TestJsonEventReaderUnsupportedTokens() {
+  for (const string_view json : {"[true]", "[1, null]", "{\"a\": -}", "[1.5]", "[\xe9]"}) {
+    Json::EventReader reader(json);
+    bool is_thrown = false;
+    try {
+      while (reader.Next().type != Events::EventType::EndDocument) {
+      }
+    } catch (const invalid_argument&) {
+      is_thrown = true;
+    }
+    Assert(is_thrown, string(json));
+  }
+}
+
+void TestXmlEventReader() {
+  using Events::EventType;
+
+  Xml::EventReader reader(
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<july>\n"
+    "  <spend amount=\"2500\" category=food/>\n"
+    "  <spend category='sport'><note>text</note></spend>\n"
+    "</july>\n"
+  );
+  const vector<pair<EventType, string_view>> expected = {
+    {EventType::StartObject, ""}, {EventType::Key, "july"}, {EventType::StartObject, ""},
+    {EventType::Key, "attributes"}, {EventType::StartObject, ""}, {EventType::End, ""},
+    {EventType::Key, "children"}, {EventType::StartArray, ""},
+    {EventType::StartObject, ""}, {EventType::Key, "spend"}, {EventType::StartObject, ""},
+    {EventType::Key, "attributes"}, {EventType::StartObject, ""},
+    {EventType::Key, "amount"}, {EventType::String, "2500"}, {EventType::Key, "category"}, {EventType::String, "food"},
+    {EventType::End, ""}, {EventType::Key, "children"}, {EventType::StartArray, ""},
+    {EventType::End, ""}, {EventType::End, ""}, {EventType::End, ""},
+    {EventType::StartObject, ""}, {EventType::Key, "spend"}, {EventType::StartObject, ""},
+    {EventType::Key, "attributes"}, {EventType::StartObject, ""}, {EventType::Key, "category"}, {EventType::String, "sport"},
+    {EventType::End, ""}, {EventType::Key, "children"}, {EventType::StartArray, ""},
+    {EventType::StartObject, ""}, {EventType::Key, "note"}, {EventType::StartObject, ""},
+    {EventType::Key, "attributes"}, {EventType::StartObject, ""}, {EventType::End, ""},
+    {EventType::Key, "children"}, {EventType::StartArray, ""},
+    {EventType::End, ""}, {EventType::End, ""}, {EventType::End, ""},
+    {EventType::End, ""}, {EventType::End, ""}, {EventType::End, ""},
+    {EventType::End, ""}, {EventType::End, ""}, {EventType::End, ""},
+    {EventType::EndDocument, ""}, {EventType::EndDocument, ""},
+  };
+
+  for (size_t i = 0; i < expected.size(); ++i) {
+    const Events::Event event = reader.Next();
+    const string feedback_msg = "i = " + to_string(i);
+    Assert(event.type == expected[i].first, feedback_msg);
+    AssertEqual(event.text, expected[i].second, feedback_msg);
+  }
+}
+
+void TestIniToJson() {
+  Ini::EventReader reader(
+    "ignored=1\n"
+    "[july]\n"
+    "food=2500\n"
+    "\n"
+    "sport=12000\n"
+    "[empty]\n"
+    "[august]\n"
+    "travel=23400\n"
+  );
+  ostringstream output;
+  Json::WriteEvents(reader, output);
+  ASSERT_EQUAL(output.str(), R"({"july": {"food": "2500", "sport": "12000"}, "empty": {}, "august": {"travel": "23400"}})");
+}
+
+void TestXmlEventsToJson() {
+  Xml::EventReader reader(R"(<july><spend amount="1" category='food'><note a="x"/></spend><spend/></july>)");
+  ostringstream output;
+  Json::WriteEvents(reader, output);
+  ASSERT_EQUAL(output.str(),
+    R"({"july": {"attributes": {}, "children": [)"
+    R"({"spend": {"attributes": {"amount": "1", "category": "food"}, "children": [{"note": {"attributes": {"a": "x"}, "children": []}}]}}, )"
+    R"({"spend": {"attributes": {}, "children": []}}]}})");
+
+  istringstream input(output.str());
+  const Json::Document json_doc = Json::Load(input);
+  const Json::Node& july = json_doc.GetRoot().AsMap().at("july");
+  ASSERT(july.AsMap().at("attributes").AsMap().empty());
+  const vector<Json::Node>& spendings = july.AsMap().at("children").AsArray();
+  ASSERT_EQUAL(spendings.size(), 2u);
+
+  const map<string, Json::Node>& first = spendings[0].AsMap().at("spend").AsMap();
+  ASSERT_EQUAL(first.at("attributes").AsMap().at("amount").AsString(), "1");
+  ASSERT_EQUAL(first.at("attributes").AsMap().at("category").AsString(), "food");
+  const vector<Json::Node>& notes = first.at("children").AsArray();
+  ASSERT_EQUAL(notes.size(), 1u);
+  ASSERT_EQUAL(notes[0].AsMap().at("note").AsMap().at("attributes").AsMap().at("a").AsString(), "x");
+  ASSERT(notes[0].AsMap().at("note").AsMap().at("children").AsArray().empty());
+
+  const map<string, Json::Node>& second = spendings[1].AsMap().at("spend").AsMap();
+  ASSERT(second.at("attributes").AsMap().empty());
+  ASSERT(second.at("children").AsArray().empty());
+}
+
+void TestJsonEventWriterRejectsValuesWithoutKeys() {
+  using Events::EventType;
+
+  const vector<vector<Events::Event>> streams = {
+    {{EventType::StartObject}, {EventType::String, "value"}},
+    {{EventType::StartObject}, {EventType::StartObject}},
+    {{EventType::StartArray}, {EventType::Key, "key"}},
+    {{EventType::StartObject}, {EventType::Key, "key"}, {EventType::Key, "other"}},
+    {{EventType::StartObject}, {EventType::Key, "key"}, {EventType::End}},
+  };
+
+  for (size_t i = 0; i < streams.size(); ++i) {
+    ostringstream output;
+    Json::EventWriter writer(output);
+    bool is_rejected = false;
+    try {
+      for (const Events::Event& event : streams[i]) {
+        writer.Write(event);
+      }
+    } catch (const invalid_argument&) {
+      is_rejected = true;
+    }
+    Assert(is_rejected, "i = " + to_string(i));
+  }
+}
+
+void TestXmlToJsonStreaming() {
+  const string xml =
+    "<july>\n"
+    "  <spend amount=\"23400\" category=\"travel\"></spend>\n"
+    "  <spend amount=\"5000\" category=\"food\"></spend>\n"
+    "  <spend amount=\"1150\" category=\"transport\"></spend>\n"
+    "  <spend amount=\"12000\" category=\"sport\"></spend>\n"
+    "</july>\n";
+
+  ostringstream output;
+  XmlToJson(xml, output);
+  istringstream input(output.str());
+  const Json::Document json_doc = Json::Load(input);
+
+  // the same result as converting the loaded document
+  istringstream xml_input(xml);
+  const Json::Document expected_doc = XmlToJson(Xml::Load(xml_input));
+
+  const auto& items = json_doc.GetRoot().AsArray();
+  const auto& expected_items = expected_doc.GetRoot().AsArray();
+  ASSERT_EQUAL(items.size(), expected_items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    const string feedback_msg = "i = " + to_string(i);
+    AssertEqual(items[i].AsMap().at("category").AsString(), expected_items[i].AsMap().at("category").AsString(), feedback_msg);
+    AssertEqual(items[i].AsMap().at("amount").AsInt(), expected_items[i].AsMap().at("amount").AsInt(), feedback_msg);
+  }
+}
+
+void TestXmlToJsonStreamingMissingAttribute() {
+  for (const string xml : {
+    "<july>\n  <spend category=\"food\"></spend>\n</july>\n",
+    "<july>\n  <spend amount=\"2500\"></spend>\n</july>\n",
+  }) {
+    // the loaded document throws for the missing attribute as well
+    bool is_thrown = false;
+    try {
+      istringstream xml_input(xml);
+      XmlToJson(Xml::Load(xml_input));
+    } catch (const out_of_range&) {
+      is_thrown = true;
+    }
+    Assert(is_thrown, xml);
+
+    is_thrown = false;
+    ostringstream output;
+    try {
+      XmlToJson(xml, output);
+    } catch (const out_of_range&) {
+      is_thrown = true;
+    }
+    Assert(is_thrown, xml);
+  }
+}
+
+void TestJsonToXmlStreaming() {
+  const string json = R"([
+    {"amount": 2500, "category": "food"},
+    {"category": "transport", "amount": 1150, "tags": ["bus", {"night": 1}]},
+    {"amount": 23740, "category": "travel"}
+  ])";
+
+  ostringstream output;
+  JsonToXml(json, output, "month");
+  istringstream input(output.str());
+  const Xml::Document xml_doc = Xml::Load(input);
+  const Xml::Node& root = xml_doc.GetRoot();
+
+  ASSERT_EQUAL(root.Name(), "month");
+  const vector<Xml::Node>& children = root.Children();
+  ASSERT_EQUAL(children.size(), 3u);
+
+  const vector<string> expected_category = {"food", "transport", "travel"};
+  const vector<int> expected_amount = {2500, 1150, 23740};
+  for (size_t i = 0; i < children.size(); ++i) {
+    const string feedback_msg = "i = " + to_string(i);
+    AssertEqual(children[i].Name(), "spend", feedback_msg);
+    AssertEqual(children[i].AttributeValue<string>("category"), expected_category[i], feedback_msg);
+    AssertEqual(children[i].AttributeValue<int>("amount"), expected_amount[i], feedback_msg);
+  }
+}
+
 int main() {
   TestRunner tr;
   RUN_TEST(tr, TestXmlToJson);
   RUN_TEST(tr, TestJsonToXml);
+  RUN_TEST(tr, TestJsonEventReader);
+  RUN_TEST(tr, TestJsonEventReaderUnsupportedTokens);
+  RUN_TEST(tr, TestXmlEventReader);
+  RUN_TEST(tr, TestIniToJson);
+  RUN_TEST(tr, TestXmlEventsToJson);
+  RUN_TEST(tr, TestJsonEventWriterRejectsValuesWithoutKeys);
+  RUN_TEST(tr, TestXmlToJsonStreaming);
+  RUN_TEST(tr, TestXmlToJsonStreamingMissingAttribute);
+  RUN_TEST(tr, TestJsonToXmlStreaming);
   return 0;
 }
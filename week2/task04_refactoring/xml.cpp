@@ -85,4 +85,96 @@ string_view Node::Name() const {
   return name;
 }
 
+EventReader::EventReader(string_view buffer) : rest(buffer) {
+}
+
+Events::Event EventReader::Next() {
+  using Events::EventType;
+
+  if (queued_begin < queued_end) {
+    return queued[queued_begin++];
+  }
+  queued_begin = queued_end = 0;
+
+  if (attr_value) {
+    const string_view value = *attr_value;
+    attr_value.reset();
+    return {EventType::String, value};
+  }
+
+  if (in_start_tag) {
+    attrs = Lstrip(attrs);
+    if (!attrs.empty()) {
+      const size_t name_end = min(attrs.find_first_of("= \t\r\n"), attrs.size());
+      const string_view name = attrs.substr(0, name_end);
+      attrs = Lstrip(attrs.substr(name_end));
+      if (attrs.empty() || attrs.front() != '=') {
+        attr_value = string_view();
+        return {EventType::Key, name};
+      }
+
+      attrs = Lstrip(attrs.substr(1));
+      if (!attrs.empty() && (attrs.front() == '"' || attrs.front() == '\'')) {
+        const size_t quote_pos = min(attrs.find(attrs.front(), 1), attrs.size());
+        attr_value = attrs.substr(1, quote_pos - 1);
+        attrs.remove_prefix(min(quote_pos + 1, attrs.size()));
+      } else {
+        const size_t value_end = min(attrs.find_first_of(" \t\r\n"), attrs.size());
+        attr_value = attrs.substr(0, value_end);
+        attrs.remove_prefix(value_end);
+      }
+      return {EventType::Key, name};
+    }
+
+    in_start_tag = false;
+    Queue({EventType::Key, "children"});
+    Queue({EventType::StartArray});
+    if (is_self_closing) {
+      is_self_closing = false;
+      Queue({EventType::End});
+      Queue({EventType::End});
+      Queue({EventType::End});
+    }
+    return {EventType::End};  // of the attributes
+  }
+
+  // like Load, a '>' inside an attribute value is not supported
+  while (true) {
+    const size_t open_pos = rest.find('<');
+    if (open_pos == string_view::npos) {
+      rest = {};
+      return {EventType::EndDocument};
+    }
+    const size_t close_pos = min(rest.find('>', open_pos), rest.size());
+    string_view tag = rest.substr(open_pos + 1, close_pos - open_pos - 1);
+    rest.remove_prefix(min(close_pos + 1, rest.size()));
+
+    if (tag.empty() || tag.front() == '?' || tag.front() == '!') {
+      continue;
+    }
+    if (tag.front() == '/') {
+      // the children array, the object under the name and the element
+      Queue({EventType::End});
+      Queue({EventType::End});
+      return {EventType::End};
+    }
+    if (tag.back() == '/') {
+      is_self_closing = true;
+      tag.remove_suffix(1);
+    }
+    const size_t name_end = min(tag.find_first_of(" \t\r\n"), tag.size());
+    attrs = tag.substr(name_end);
+    in_start_tag = true;
+    Queue({EventType::Key, tag.substr(0, name_end)});
+    Queue({EventType::StartObject});
+    Queue({EventType::Key, "attributes"});
+    Queue({EventType::StartObject});
+    return {EventType::StartObject};
+  }
+}
+
+void EventReader::Queue(Events::Event event) {
+  queued[queued_end++] = event;
+}
+
 }
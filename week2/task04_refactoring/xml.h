@@ -1,6 +1,10 @@
 #pragma once
 
+#include "document_events.h"
+
+#include <array>
 #include <istream>
+#include <optional>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -38,6 +42,31 @@ private:
 
 Document Load(std::istream& input);
 
+// Events of the Xml text in buffer, which must outlive the reader. Every element is reported as
+// an object with a single Key, its name, holding an object with the "attributes" object, a Key and
+// a String for each attribute, and the "children" array of the child elements in the same shape:
+// <spend amount="1"><note/></spend> reads as {"spend": {"attributes": {"amount": "1"},
+// "children": [{"note": {"attributes": {}, "children": []}}]}}.
+// Text between tags, declarations and comments are skipped.
+class EventReader : public Events::EventReader {
+public:
+  explicit EventReader(std::string_view buffer);
+
+  Events::Event Next() override;
+
+private:
+  std::string_view rest;
+  std::string_view attrs;  // not reported yet, of the last start tag
+  std::optional<std::string_view> attr_value;
+  bool in_start_tag = false;  // the attributes of the last start tag are not closed yet
+  bool is_self_closing = false;  // the last start tag, whose End events are not reported yet
+  std::array<Events::Event, 5> queued;  // a tag gives up to six events, the first is returned at once
+  size_t queued_begin = 0;
+  size_t queued_end = 0;
+
+  void Queue(Events::Event event);
+};
+
 
 
 
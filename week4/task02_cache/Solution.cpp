@@ -1,5 +1,7 @@
-#include <algorithm>
+#include <iterator>
+#include <list>
 #include <mutex>
+#include <string_view>
 #include <unordered_map>
 
 #include "Common.h"
@@ -15,46 +17,47 @@ public:
     BookPtr GetBook(const string &book_name) override {
         {
             auto lg = lock_guard<mutex>(m);
-            if (auto cache_it = cache.find(book_name); cache_it != cache.end()) {
-                cache_it->second.rank = last_rank++;
-                return cache_it->second.book;
+            if (auto index_it = index.find(book_name); index_it != index.end()) {
+                recency.splice(recency.begin(), recency, index_it->second);
+                return recency.front();
             }
         }
         BookPtr book_ptr = books_unpacker_->UnpackBook(book_name);
+        const size_t book_size = book_ptr->GetContent().size();
 
         {
             auto lg = lock_guard<mutex>(m);
-            while (!cache.empty() && current_size + book_ptr->GetContent().size() > settings_.max_memory) {
-                auto it_to_remove = min_element(cache.begin(), cache.end(),
-                                                [](const pair<string, CacheItem> &lhs, const pair<string, CacheItem> &rhs) { return lhs.second < rhs.second; });
-                current_size -= it_to_remove->second.book->GetContent().size();
-                cache.erase(it_to_remove);
-
+            // another thread could have unpacked the same book meanwhile, its copy is replaced
+            if (auto index_it = index.find(book_ptr->GetName()); index_it != index.end()) {
+                Remove(index_it->second);
+            }
+            while (!recency.empty() && current_size + book_size > settings_.max_memory) {
+                Remove(prev(recency.end()));
             }
-            if (current_size + book_ptr->GetContent().size() <= settings_.max_memory) {
-                cache[book_ptr->GetName()] = {book_ptr, last_rank++};
-                current_size += book_ptr->GetContent().size();
+            if (current_size + book_size <= settings_.max_memory) {
+                recency.push_front(book_ptr);
+                index.emplace(recency.front()->GetName(), recency.begin());
+                current_size += book_size;
             }
         }
         return book_ptr;
     }
 
 private:
-    struct CacheItem {
-        BookPtr book;
-        size_t rank;
-
-        bool operator<(const CacheItem &other) const {
-            return this->rank < other.rank;
-        }
-    };
+    using Recency = list<BookPtr>;
 
     shared_ptr<IBooksUnpacker> books_unpacker_;
     Settings settings_;
-    unordered_map<string, CacheItem> cache;
-    size_t last_rank = 0, current_size = 0;
+    Recency recency;  // most recently used first
+    unordered_map<string_view, Recency::iterator> index;  // keys are names of the books in recency
+    size_t current_size = 0;
     mutex m;
 
+    void Remove(Recency::iterator it) {
+        current_size -= (*it)->GetContent().size();
+        index.erase((*it)->GetName());  // before the book that owns the key goes away
+        recency.erase(it);
+    }
 };
 
 
@@ -147,6 +147,31 @@ void TestSmallCache(const Library& lib) {
 }
 
 
+void TestEvictionOrder(const Library& lib) {
+  auto unpacker = make_shared<BooksUnpacker>();
+  ICache::Settings settings;
+  for (size_t i = 0; i < 3; ++i) {
+    settings.max_memory += lib.content.at(lib.book_names[i])->GetContent().size();
+  }
+  auto cache = MakeCache(unpacker, settings);
+
+  cache->GetBook(lib.book_names[0]);
+  cache->GetBook(lib.book_names[1]);
+  cache->GetBook(lib.book_names[2]);
+  cache->GetBook(lib.book_names[0]);  // now book 1 is the least recently used
+  ASSERT_EQUAL(unpacker->GetUnpackedBooksCount(), 3);
+
+  // book 3 is larger than book 1 but smaller than books 1 and 2 together, so both of them go
+  cache->GetBook(lib.book_names[3]);
+  ASSERT_EQUAL(unpacker->GetUnpackedBooksCount(), 4);
+  cache->GetBook(lib.book_names[0]);
+  ASSERT_EQUAL(unpacker->GetUnpackedBooksCount(), 4);
+  cache->GetBook(lib.book_names[1]);
+  ASSERT_EQUAL(unpacker->GetUnpackedBooksCount(), 5);
+  ASSERT(unpacker->GetMemoryUsedByBooks() <= settings.max_memory);
+}
+
+
 void TestAsync(const Library& lib) {
   static const int tasks_count = 10;
   static const int trials_count = 10000;
@@ -209,6 +234,7 @@ int main() {
   RUN_CACHE_TEST(tr, TestMaxMemory);
   RUN_CACHE_TEST(tr, TestCaching);
   RUN_CACHE_TEST(tr, TestSmallCache);
+  RUN_CACHE_TEST(tr, TestEvictionOrder);
   RUN_CACHE_TEST(tr, TestAsync);
 
 #undef RUN_CACHE_TEST
@@ -1,10 +1,14 @@
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <iostream>
-#include <memory>
+#include <iterator>
 #include <set>
-#include <sstream>
+#include <stdexcept>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 
 using namespace std;
 
@@ -28,19 +32,31 @@ struct Coords {
     }
 };
 
+// Parsed requests keep string_views into the whole input buffer (see ReadWholeInput), which must outlive them.
+// Stop names are interned while parsing, so every name is looked up once and then referred to by id.
 struct AddStopRequest {
-    string stop_name;
+    size_t stop_id;
     Coords coords;
 };
 
 struct AddBusRequest {
-    string bus_name;
-    vector<string> stops;
+    string_view bus_name;
+    vector<size_t> stop_ids;
 };
 
 struct DbInputRequests {
-    vector<unique_ptr<AddStopRequest>> add_stop_requests;
-    vector<unique_ptr<AddBusRequest>> add_bus_requests;
+    vector<string_view> stop_names;  // by stop id
+    unordered_map<string_view, size_t> stop_ids;
+    vector<AddStopRequest> add_stop_requests;
+    vector<AddBusRequest> add_bus_requests;
+
+    size_t InternStop(string_view stop_name) {
+        auto it = stop_ids.try_emplace(stop_name, stop_names.size()).first;
+        if (it->second == stop_names.size()) {
+            stop_names.push_back(stop_name);
+        }
+        return it->second;
+    }
 };
 
 
@@ -60,12 +76,20 @@ public:
     }
 
 
-    void ApplyFillRequests(DbInputRequests requests) {
-        for (unique_ptr<AddStopRequest> &stop_req : requests.add_stop_requests) {
-            AddStop(move(stop_req->stop_name), move(stop_req->coords));
+    void ApplyFillRequests(const DbInputRequests &requests) {
+        // names are copied out of the input buffer once each
+        const vector<string> stop_names(requests.stop_names.begin(), requests.stop_names.end());
+
+        for (const AddStopRequest &stop_req : requests.add_stop_requests) {
+            AddStop(stop_names[stop_req.stop_id], stop_req.coords);
         }
-        for (unique_ptr<AddBusRequest> &bus_req : requests.add_bus_requests) {
-            AddBus(move(bus_req->bus_name), move(bus_req->stops));
+        for (const AddBusRequest &bus_req : requests.add_bus_requests) {
+            vector<string> bus_stops;
+            bus_stops.reserve(bus_req.stop_ids.size());
+            for (size_t stop_id : bus_req.stop_ids) {
+                bus_stops.push_back(stop_names[stop_id]);
+            }
+            AddBus(string(bus_req.bus_name), move(bus_stops));
         }
     }
 
@@ -113,85 +137,105 @@ private:
 };
 
 
-unique_ptr<AddStopRequest> ParseStopInputRequest(string line) {
-    stringstream ss(line);
-    string stop_name;
-    double latitude, longitude;
+string ReadWholeInput(istream &is) {
+    return string(istreambuf_iterator<char>(is), {});
+}
 
-    ss.ignore(5);  // "Stop " length
-    getline(ss, stop_name, ':');
-    ss >> latitude;
-    ss.ignore();  // ", "
-    ss >> longitude;
+// Takes the next line off the front of input, without the '\n'
+string_view NextLine(string_view &input) {
+    const size_t line_end = min(input.find('\n'), input.size());
+    string_view line = input.substr(0, line_end);
+    input.remove_prefix(min(line_end + 1, input.size()));
+    return line;
+}
+
+// Takes the prefix up to delimiter off the front of s, the delimiter is dropped; all of s if there is none
+string_view NextToken(string_view &s, string_view delimiter) {
+    const size_t token_end = min(s.find(delimiter), s.size());
+    string_view token = s.substr(0, token_end);
+    s.remove_prefix(min(token_end + delimiter.size(), s.size()));
+    return token;
+}
+
+double NextDouble(string_view &s) {
+    while (!s.empty() && s.front() == ' ') {
+        s.remove_prefix(1);
+    }
+    double res = 0;
+    auto[number_end, ec] = from_chars(s.data(), s.data() + s.size(), res);
+    if (ec != errc()) {
+        throw invalid_argument("number expected: " + string(s));
+    }
+    s.remove_prefix(number_end - s.data());
+    return res;
+}
 
-    return make_unique<AddStopRequest>(AddStopRequest{stop_name, {latitude, longitude}});
+size_t NextCount(string_view &input) {
+    string_view line = NextLine(input);
+    size_t res = 0;
+    from_chars(line.data(), line.data() + line.size(), res);
+    return res;
 }
 
-unique_ptr<AddBusRequest> ParseBusInputRequest(string line) {
-    string bus_name;
-    vector<string> stops;
+AddStopRequest ParseStopInputRequest(string_view line, DbInputRequests &requests) {
+    line.remove_prefix(5);  // "Stop " length
+    const size_t stop_id = requests.InternStop(NextToken(line, ": "));
+
+    const double latitude = NextDouble(line);
+    NextToken(line, ",");
+    const double longitude = NextDouble(line);
+
+    return {stop_id, {latitude, longitude}};
+}
 
-    size_t colon_pos = line.find(':', 4 /* "Bus " length */);
-    bus_name = line.substr(4 /* "Bus " length */, (colon_pos - 4));
+AddBusRequest ParseBusInputRequest(string_view line, DbInputRequests &requests) {
+    line.remove_prefix(4);  // "Bus " length
+    string_view bus_name = NextToken(line, ": ");
 
-    size_t first_delim_pos = line.find_first_of(">-", colon_pos);
-    bool is_circular = line[first_delim_pos] == '>';
-    string delim = is_circular ? " > " : " - ";
-    size_t delim_pos, prev_delim_pos = colon_pos + 2;  // ": " length
-    while ((delim_pos = line.find(delim, prev_delim_pos)) != string::npos) {
-        stops.push_back(line.substr(prev_delim_pos, (delim_pos - prev_delim_pos)));
-        prev_delim_pos = delim_pos + 3;
+    const bool is_circular = line.find(" > ") != string_view::npos;
+    const string_view delim = is_circular ? " > " : " - ";
+    vector<size_t> stop_ids;
+    while (!line.empty()) {
+        stop_ids.push_back(requests.InternStop(NextToken(line, delim)));
     }
-    stops.push_back(line.substr(prev_delim_pos, string::npos));
 
     if (!is_circular) {  // зациклить
-        for (int i = static_cast<int>(stops.size()) - 2; i >= 0; --i) {
-            stops.push_back(stops[i]);
+        for (int i = static_cast<int>(stop_ids.size()) - 2; i >= 0; --i) {
+            stop_ids.push_back(stop_ids[i]);
         }
     }
 
-    return make_unique<AddBusRequest>(AddBusRequest{move(bus_name), move(stops)});
+    return {bus_name, move(stop_ids)};
 }
 
 
-DbInputRequests ParseDbInput() {
+DbInputRequests ParseDbInput(string_view &input) {
     DbInputRequests res;
 
-    string line;
-    getline(cin, line);
-    int N = stoi(line);
+    const size_t N = NextCount(input);
+    for (size_t n = 0; n < N; ++n) {
+        string_view line = NextLine(input);
 
-    for (int n = 0; n < N; ++n) {
-        getline(cin, line);
-
-        if (string_view(line).substr(0, 4) == "Stop") {
-            res.add_stop_requests.push_back(ParseStopInputRequest(move(line)));
-        } else if (string_view(line).substr(0, 3) == "Bus") {
-            res.add_bus_requests.push_back(ParseBusInputRequest(move(line)));
+        if (line.substr(0, 4) == "Stop") {
+            res.add_stop_requests.push_back(ParseStopInputRequest(line, res));
+        } else if (line.substr(0, 3) == "Bus") {
+            res.add_bus_requests.push_back(ParseBusInputRequest(line, res));
         }
     }
 
     return res;
 }
 
-vector<string> ParseBusRequests() {
+vector<string> ParseBusRequests(string_view &input) {
     vector<string> res;
 
-    string line;
-    getline(cin, line);
-    int N = stoi(line);
-
-    for (int n = 0; n < N; ++n) {
-        string query;
-        cin >> query;
+    const size_t N = NextCount(input);
+    for (size_t n = 0; n < N; ++n) {
+        string_view line = NextLine(input);
+        string_view query = NextToken(line, " ");
 
         if (query == "Bus") {
-            cin.ignore();  // пробел после Bus
-            string bus_name;
-            getline(cin, bus_name);
-
-            res.push_back(move(bus_name));
-
+            res.push_back(string(line));
         }
     }
 
@@ -201,15 +245,18 @@ vector<string> ParseBusRequests() {
 int main() {
     Database db;
 
-    DbInputRequests db_input_requests = ParseDbInput();
+    const string input_buffer = ReadWholeInput(cin);
+    string_view input = input_buffer;
+
+    DbInputRequests db_input_requests = ParseDbInput(input);
 
-    db.ApplyFillRequests(move(db_input_requests));
+    db.ApplyFillRequests(db_input_requests);
 
 
     db.CalculateBusLengthes();
 
     // ==============================
-    vector<string> bus_requests = ParseBusRequests();
+    vector<string> bus_requests = ParseBusRequests(input);
 
     for (const string& bus_name : bus_requests) {
         const Database::BusInfo* bus_info = db.GetBusInfo(bus_name);
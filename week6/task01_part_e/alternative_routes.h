@@ -0,0 +1,196 @@
+#pragma once
+
+#include "graph.h"
+#include "parallel_edges.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Graph {
+
+    // Penalty method for k alternative routes: every found route makes its edges more expensive,
+    // the next single-pair Dijkstra is pushed away from them, and a candidate is kept only if
+    // it is diverse enough compared to every already kept route.
+    // Given the side table of a collapsed graph, the search also rides the dropped parallel edges, so a route
+    // that differs only by the bus on some stretch can be found as it would be in the full graph.
+    template<typename Weight>
+    class AlternativeRoutesFinder {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        // edges are ids in graph, or graph.GetEdgeCount() + i for the i-th edge of the parallel edge table
+        struct Route {
+            Weight weight;
+            std::vector<EdgeId> edges;
+        };
+
+        // weight of an edge used by n kept routes is multiplied by (1 + n * penalty_step)
+        explicit AlternativeRoutesFinder(const Graph &graph, const ParallelEdgeTable<Weight> *parallel_edges = nullptr,
+                                         double penalty_step = 0.5, size_t attempts_per_route = 4);
+
+        // Up to max_count routes ordered by weight, the first one is optimal.
+        // diversity is the minimal share (0..1) of a route weight that must not be shared with any kept route.
+        // For from == to the only route is the empty one.
+        std::vector<Route> FindRoutes(VertexId from, VertexId to, size_t max_count, double diversity) const;
+
+    private:
+        const Graph &graph_;
+        const ParallelEdgeTable<Weight> *parallel_edges_;
+        double penalty_step_;
+        size_t attempts_per_route_;
+
+        std::optional<Route> FindPenalizedRoute(VertexId from, VertexId to, const std::unordered_map<EdgeId, size_t> &edge_uses) const;
+
+        Weight RouteEdgeWeight(EdgeId route_edge_id) const;
+
+        // the penalized weight and route edge id of the cheapest of a graph edge and the edges parallel to it
+        std::pair<double, EdgeId> CheapestParallelEdge(EdgeId edge_id, const std::unordered_map<EdgeId, size_t> &edge_uses) const;
+
+        bool IsDiverseEnough(const Route &candidate, const std::vector<Route> &kept, double diversity) const;
+    };
+
+
+    template<typename Weight>
+    AlternativeRoutesFinder<Weight>::AlternativeRoutesFinder(const Graph &graph, const ParallelEdgeTable<Weight> *parallel_edges,
+                                                             double penalty_step, size_t attempts_per_route)
+            : graph_(graph), parallel_edges_(parallel_edges), penalty_step_(penalty_step), attempts_per_route_(attempts_per_route) {}
+
+    template<typename Weight>
+    std::vector<typename AlternativeRoutesFinder<Weight>::Route>
+    AlternativeRoutesFinder<Weight>::FindRoutes(VertexId from, VertexId to, size_t max_count, double diversity) const {
+        std::vector<Route> kept;
+        if (from == to) {
+            if (max_count > 0) {
+                kept.push_back({0, {}});
+            }
+            return kept;
+        }
+        std::unordered_map<EdgeId, size_t> edge_uses;
+
+        for (size_t attempt = 0; kept.size() < max_count && attempt < max_count * attempts_per_route_; ++attempt) {
+            std::optional<Route> candidate = FindPenalizedRoute(from, to, edge_uses);
+            if (!candidate) {
+                break;
+            }
+            for (EdgeId edge_id : candidate->edges) {
+                ++edge_uses[edge_id];
+            }
+            if (kept.empty() || IsDiverseEnough(*candidate, kept, diversity)) {
+                kept.push_back(std::move(*candidate));
+            }
+        }
+
+        std::stable_sort(kept.begin(), kept.end(), [](const Route &lhs, const Route &rhs) {
+            return lhs.weight < rhs.weight;
+        });
+        return kept;
+    }
+
+    template<typename Weight>
+    std::optional<typename AlternativeRoutesFinder<Weight>::Route>
+    AlternativeRoutesFinder<Weight>::FindPenalizedRoute(VertexId from, VertexId to, const std::unordered_map<EdgeId, size_t> &edge_uses) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        std::vector<std::optional<double>> penalized_dist(vertex_count);
+        std::vector<std::optional<EdgeId>> prev_edge(vertex_count);  // route edge id
+        std::vector<VertexId> prev_vertex(vertex_count);
+
+        using QueueItem = std::pair<double, VertexId>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+        penalized_dist[from] = 0;
+        queue.push({0, from});
+
+        while (!queue.empty()) {
+            const auto[dist, vertex] = queue.top();
+            queue.pop();
+            if (dist > *penalized_dist[vertex]) {
+                continue;
+            }
+            if (vertex == to) {
+                break;
+            }
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto &edge = graph_.GetEdge(edge_id);
+                const auto[edge_weight, route_edge_id] = CheapestParallelEdge(edge_id, edge_uses);
+                if (!penalized_dist[edge.to] || dist + edge_weight < *penalized_dist[edge.to]) {
+                    penalized_dist[edge.to] = dist + edge_weight;
+                    prev_edge[edge.to] = route_edge_id;
+                    prev_vertex[edge.to] = vertex;
+                    queue.push({dist + edge_weight, edge.to});
+                }
+            }
+        }
+
+        if (!penalized_dist[to]) {
+            return std::nullopt;
+        }
+
+        Route route{0, {}};
+        for (VertexId vertex = to; vertex != from; vertex = prev_vertex[vertex]) {
+            route.edges.push_back(*prev_edge[vertex]);
+            route.weight += RouteEdgeWeight(*prev_edge[vertex]);
+        }
+        std::reverse(route.edges.begin(), route.edges.end());
+        return route;
+    }
+
+    template<typename Weight>
+    Weight AlternativeRoutesFinder<Weight>::RouteEdgeWeight(EdgeId route_edge_id) const {
+        const size_t edge_count = graph_.GetEdgeCount();
+        return route_edge_id < edge_count ? graph_.GetEdge(route_edge_id).weight : parallel_edges_->weights[route_edge_id - edge_count];
+    }
+
+    template<typename Weight>
+    std::pair<double, EdgeId>
+    AlternativeRoutesFinder<Weight>::CheapestParallelEdge(EdgeId edge_id, const std::unordered_map<EdgeId, size_t> &edge_uses) const {
+        auto penalized = [this, &edge_uses](double weight, EdgeId route_edge_id) {
+            if (auto it = edge_uses.find(route_edge_id); it != edge_uses.end()) {
+                weight *= 1 + it->second * penalty_step_;
+            }
+            return weight;
+        };
+
+        std::pair<double, EdgeId> res{penalized(graph_.GetEdge(edge_id).weight, edge_id), edge_id};
+        if (!parallel_edges_) {
+            return res;
+        }
+        // the group is ordered by weight and penalties only add, so the rest can't be cheaper once a weight is not
+        const size_t edge_count = graph_.GetEdgeCount();
+        for (size_t i = parallel_edges_->group_begin[edge_id]; i < parallel_edges_->group_begin[edge_id + 1]; ++i) {
+            const double weight = parallel_edges_->weights[i];
+            if (weight >= res.first) {
+                break;
+            }
+            const double parallel_weight = penalized(weight, edge_count + i);
+            if (parallel_weight < res.first) {
+                res = {parallel_weight, edge_count + i};
+            }
+        }
+        return res;
+    }
+
+    template<typename Weight>
+    bool AlternativeRoutesFinder<Weight>::IsDiverseEnough(const Route &candidate, const std::vector<Route> &kept, double diversity) const {
+        for (const Route &other : kept) {
+            if (candidate.edges == other.edges) {
+                return false;
+            }
+            Weight shared_weight = 0;
+            for (EdgeId edge_id : candidate.edges) {
+                if (std::find(other.edges.begin(), other.edges.end(), edge_id) != other.edges.end()) {
+                    shared_weight += RouteEdgeWeight(edge_id);
+                }
+            }
+            if (candidate.weight - shared_weight < diversity * candidate.weight) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "database.h"
+#include "json.h"
+#include "parse_input.h"
+#include "requests_read.h"
+#include "synthetic_network.h"
+
+using namespace std;
+
+
+namespace {
+
+    struct Phase {
+        string name;
+        size_t request_count = 0;  // 0 for build phases
+        vector<double> ms_by_size;
+    };
+
+    template<typename Func>
+    double MeasureMs(Func func) {
+        const auto start = chrono::steady_clock::now();
+        func();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    // serves all requests and returns the total response size, so the work is not optimized away
+    size_t ServeAll(const Database &db, const vector<unique_ptr<ReadRequest>> &requests) {
+        size_t response_size = 0;
+        for (const auto &request : requests) {
+            response_size += request->ServeRequestJson(db, false).size();
+        }
+        return response_size;
+    }
+
+    void PrintReport(const vector<size_t> &stop_counts, const vector<Phase> &phases) {
+        cout << left << setw(22) << "phase \\ stops";
+        for (size_t stop_count : stop_counts) {
+            cout << right << setw(12) << stop_count;
+        }
+        cout << right << setw(12) << "exponent" << "\n";
+
+        cout << fixed << setprecision(2);
+        for (const Phase &phase : phases) {
+            cout << left << setw(22) << (phase.request_count ? phase.name + ", us/req" : phase.name + ", ms");
+            for (double ms : phase.ms_by_size) {
+                cout << right << setw(12) << (phase.request_count ? ms * 1000 / phase.request_count : ms);
+            }
+            // time ~ stops^exponent between the two largest sizes
+            const size_t last = stop_counts.size() - 1;
+            if (last > 0 && phase.ms_by_size[last - 1] > 0 && phase.ms_by_size[last] > 0) {
+                cout << right << setw(12) << log(phase.ms_by_size[last] / phase.ms_by_size[last - 1]) /
+                                              log(static_cast<double>(stop_counts[last]) / stop_counts[last - 1]);
+            }
+            cout << "\n";
+        }
+    }
+
+}
+
+
+// Usage: benchmark [stop_count...], defaults to 50 100 200 400.
+// Builds a synthetic catalogue of every size and reports the time of each phase and its scaling exponent.
+int main(int argc, char *argv[]) {
+    vector<size_t> stop_counts;
+    for (int i = 1; i < argc; ++i) {
+        stop_counts.push_back(stoul(argv[i]));
+    }
+    if (stop_counts.empty()) {
+        stop_counts = {50, 100, 200, 400};
+    }
+
+    const size_t requests_per_type = 200;
+    const vector<pair<string, QueryMix>> query_types = {
+            {"Bus",       {1, 0, 0, 0, 0}},
+            {"Stop",      {0, 1, 0, 0, 0}},
+            {"Route",     {0, 0, 1, 0, 0}},
+            {"Routes k=3", {0, 0, 0, 1, 0}},
+            {"Isochrone", {0, 0, 0, 0, 1}},
+    };
+
+    vector<Phase> phases = {Phase{"parse", 0, {}}, Phase{"fill", 0, {}}, Phase{"routes graph", 0, {}}};
+    for (const auto &[name, mix] : query_types) {
+        phases.push_back(Phase{name, requests_per_type, {}});
+    }
+
+    size_t checksum = 0;
+    for (size_t stop_count : stop_counts) {
+        SyntheticNetworkParams params;
+        params.stop_count = stop_count;
+        params.bus_count = max<size_t>(1, stop_count / 4);
+        params.stat_request_count = 0;
+        const string input = GenerateSyntheticNetworkJson(params);
+
+        tuple<DbInputRequests, vector<unique_ptr<ReadRequest>>, RoutingSettings> requests;
+        phases[0].ms_by_size.push_back(MeasureMs([&] {
+            istringstream is(input);
+            requests = ParseRequestsJson(is);
+        }));
+
+        Database db;
+        phases[1].ms_by_size.push_back(MeasureMs([&] { db.ApplyFillRequests(move(get<0>(requests))); }));
+        phases[2].ms_by_size.push_back(MeasureMs([&] { db.FillRoutesGraph(get<2>(requests)); }));
+
+        for (size_t type_idx = 0; type_idx < query_types.size(); ++type_idx) {
+            const string stat_requests_json = GenerateStatRequestsJson(params, query_types[type_idx].second, requests_per_type);
+            const vector<unique_ptr<ReadRequest>> read_requests = ParseReadRequestsJson(Json::Load(string_view(stat_requests_json)).GetRoot());
+            phases[3 + type_idx].ms_by_size.push_back(MeasureMs([&] { checksum += ServeAll(db, read_requests); }));
+        }
+    }
+
+    PrintReport(stop_counts, phases);
+    cerr << "checksum: " << checksum << "\n";
+}
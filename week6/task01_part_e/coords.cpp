@@ -13,4 +13,12 @@ double Coords::operator-(const Coords &other) const {
 
 
 Coords::Coords(double latitude_degrees, double longitude_degrees) : latitude_degrees(latitude_degrees), longitude_degrees(longitude_degrees),
-                                                                    latitude(latitude_degrees / 180 * PI), longitude(longitude_degrees / 180 * PI) {}
\ No newline at end of file
+                                                                    latitude(latitude_degrees / 180 * PI), longitude(longitude_degrees / 180 * PI) {}
+
+double Coords::GetLatitudeDegrees() const {
+    return latitude_degrees;
+}
+
+double Coords::GetLongitudeDegrees() const {
+    return longitude_degrees;
+}
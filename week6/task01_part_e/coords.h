@@ -7,6 +7,10 @@ public:
 
     double operator-(const Coords &other) const;
 
+    double GetLatitudeDegrees() const;
+
+    double GetLongitudeDegrees() const;
+
 private:
     constexpr static const double PI = 3.1415926535;
 
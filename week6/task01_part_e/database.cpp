@@ -1,37 +1,61 @@
+#include <algorithm>
+#include <array>
+#include <future>
+#include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <sstream>
+#include <thread>
 #include <utility>
 
 #include "database.h"
+#include "json.h"
+#include "walking_transfers.h"
 
 using namespace std;
 
-double Database::Stop::GetDistanceTo(const string &this_stop_name, const string &to_stop_name, const Database::Stop &to_stop) const {
-    auto it = distances.find(to_stop_name);
-    if (it != distances.end()) {
-        return it->second;
-    } else {
-        return to_stop.distances.at(this_stop_name);
+void Database::AddStop(string name, Coords coords, unordered_map<string, double> distances) {
+    auto it = stops.insert({move(name), {coords, {}, stops.size(), static_cast<size_t>(-1)}});
+    if (!it.second) {
+        return;
+    }
+    stops_by_id.push_back(&*it.first);
+    is_fill_finished = false;
+
+    // the stops a distance points to may come later, names are resolved in FinishFill
+    for (auto &[to_stop_name, meters] : distances) {
+        pending_road_distances.push_back({it.first->second.id, to_stop_name, meters});
     }
 }
 
-void Database::AddStop(string name, Coords coords, unordered_map<string, double> distances) {
-    stops.insert({move(name), {coords, move(distances), {}, static_cast<size_t>(-1)}});
+void Database::AddBus(string bus_name, vector<string> stops_to_add, bool is_roundtrip) {
+    vector<size_t> stop_ids;
+    stop_ids.reserve(stops_to_add.size());
+    for (const string &stop_name : stops_to_add) {
+        stop_ids.push_back(stops.at(stop_name).id);
+    }
+    AddBus(move(bus_name), move(stop_ids), is_roundtrip);
 }
 
-void Database::AddBus(string bus_name, vector<string> stops_to_add) {
-    size_t stops_amount = stops_to_add.size();
-    size_t stops_amount_unique = CalculateUniqueStops(stops_to_add);
-    double bus_coords_length = CalculateCoordsLength(stops_to_add);
-    double bus_real_length = CalculateRealLength(stops_to_add);
+void Database::AddBus(string bus_name, vector<size_t> stop_ids, bool is_roundtrip) {
+    // a linear bus goes back over the same stops, but they are stored only once
+    size_t stops_amount = is_roundtrip || stop_ids.empty() ? stop_ids.size() : stop_ids.size() * 2 - 1;
+    size_t stops_amount_unique = CalculateUniqueStops(stop_ids);
+    double bus_coords_length = CalculateCoordsLength(stop_ids, is_roundtrip);
 
-    auto it = buses.insert({move(bus_name), {move(stops_to_add), stops_amount, stops_amount_unique, bus_coords_length, bus_real_length}});
+    auto it = buses.insert({move(bus_name), {bus_stats.num_stops.size(), move(stop_ids), is_roundtrip}});
+    if (!it.second) {
+        return;
+    }
+    // the real length needs road distances of stops that may come later, it is filled in by FinishFill
+    bus_stats.Append({stops_amount, stops_amount_unique, bus_coords_length, 0});
+    buses_by_id.push_back(&*it.first);
+    is_fill_finished = false;
 
     // add Bus to all Stops
-    const vector<string> &stops_this_bus = it.first->second.stops;
     const string &this_bus_name = it.first->first;
-    for (const string &stop : stops_this_bus) {
-        stops.at(stop).stop_in_buses.insert(this_bus_name);
+    for (size_t stop_id : it.first->second.stops) {
+        stops_by_id[stop_id]->second.stop_in_buses.insert(this_bus_name);
     }
 }
 
@@ -40,82 +64,159 @@ void Database::ApplyFillRequests(DbInputRequests requests) {
         AddStop(move(stop_req.stop_name), stop_req.coords, move(stop_req.distances));
     }
     for (AddBusRequest &bus_req : requests.add_bus_requests) {
-        AddBus(move(bus_req.bus_name), move(bus_req.stops));
+        AddBus(move(bus_req.bus_name), move(bus_req.stops), bus_req.is_roundtrip);
     }
+    FinishFill();
 }
 
-double Database::CalculateRealLength(const vector<string> &bus_stops) const {
-    if (bus_stops.size() <= 1) { return 0; }
+void Database::FinishFill() {
+    if (is_fill_finished) {
+        return;
+    }
 
-    double real_length = 0;
+    auto resolvable_begin = partition(pending_road_distances.begin(), pending_road_distances.end(), [this](const PendingRoadDistance &pending) {
+        return stops.count(pending.to_stop_name) == 0;
+    });
+    for (auto it = resolvable_begin; it != pending_road_distances.end(); ++it) {
+        road_distance_entries.push_back({static_cast<uint32_t>(it->from_stop_id),
+                                         static_cast<uint32_t>(stops.at(it->to_stop_name).id), it->meters});
+    }
+    pending_road_distances.erase(resolvable_begin, pending_road_distances.end());
+    road_distances.Build(stops.size(), road_distance_entries);
+
+    for (size_t bus_id = 0; bus_id < buses_by_id.size(); ++bus_id) {
+        const Bus &bus = buses_by_id[bus_id]->second;
+        bus_stats.real_length[bus_id] = CalculateRealLength(bus.stops, bus.is_roundtrip);
+    }
+    is_fill_finished = true;
+}
 
-    auto prev_stop_name_it = begin(bus_stops), next_stop_name_it = next(prev_stop_name_it);
-    while (next_stop_name_it != bus_stops.end()) {
-        real_length += stops.at(*prev_stop_name_it).GetDistanceTo(*prev_stop_name_it, *next_stop_name_it, stops.at(*next_stop_name_it));
+double Database::CalculateRealLength(const vector<size_t> &bus_stop_ids, bool is_roundtrip) const {
+    double real_length = 0;
 
-        prev_stop_name_it++, next_stop_name_it++;
+    for (size_t i = 1; i < bus_stop_ids.size(); ++i) {
+        real_length += road_distances.Get(bus_stop_ids[i - 1], bus_stop_ids[i]);
+    }
+    if (!is_roundtrip) {  // way back from the last stop
+        for (size_t i = bus_stop_ids.size(); i-- > 1;) {
+            real_length += road_distances.Get(bus_stop_ids[i], bus_stop_ids[i - 1]);
+        }
     }
     return real_length;
 }
 
-double Database::CalculateCoordsLength(const vector<string> &bus_stops) const {
-    if (bus_stops.size() <= 1) { return 0; }
-
+double Database::CalculateCoordsLength(const vector<size_t> &bus_stop_ids, bool is_roundtrip) const {
     double coords_length = 0;
 
-    auto prev_stop_name_it = begin(bus_stops), next_stop_name_it = next(prev_stop_name_it);
-    while (next_stop_name_it != bus_stops.end()) {
-        double delta = stops.at(*prev_stop_name_it).coords - stops.at(*next_stop_name_it).coords;
-        coords_length += delta;
-
-        prev_stop_name_it++, next_stop_name_it++;
+    for (size_t i = 1; i < bus_stop_ids.size(); ++i) {
+        coords_length += stops_by_id[bus_stop_ids[i - 1]]->second.coords - stops_by_id[bus_stop_ids[i]]->second.coords;
+    }
+    if (!is_roundtrip) {  // way back from the last stop
+        for (size_t i = bus_stop_ids.size(); i-- > 1;) {
+            coords_length += stops_by_id[bus_stop_ids[i]]->second.coords - stops_by_id[bus_stop_ids[i - 1]]->second.coords;
+        }
     }
     return coords_length;
 }
 
 
 void Database::AddEdgeFromStop(size_t vertex_id_stop, const string &stop_name, int bus_wait_time) {
-    size_t from_stop_edge_id = graph->AddEdge({vertex_id_stop, vertex_id_stop + 1, static_cast<double>(bus_wait_time)});
+    graph->AddEdge({vertex_id_stop, vertex_id_stop + 1, weight_scale->FromWaitMinutes(bus_wait_time)});
     edges.push_back(make_pair(EdgeType::from_stop, make_unique<WaitRouteItem>(stop_name, bus_wait_time)));
 }
 
-void Database::AddBusEdge(const string &bus_name, const vector<string>& stops_in_bus, size_t from_stop_idx, size_t to_stop_idx, int bus_velocity) {
-    double edge_time_res = 0;
-    for (int i = from_stop_idx; i < to_stop_idx; ++i) {
-        const string& from_stop_name = stops_in_bus.at(i);
-        const string& next_stop_name = stops_in_bus.at(i+1);
+void Database::AddBusEdge(const string &bus_name, size_t from_stop_id, size_t to_stop_id, RouteWeight edge_weight, size_t span_count) {
+    graph->AddEdge({stops_by_id[from_stop_id]->second.id_in_graph + 1, stops_by_id[to_stop_id]->second.id_in_graph, edge_weight});
 
-        double bus_edge_time_minutes = stops.at(from_stop_name).GetDistanceTo(from_stop_name, next_stop_name, stops.at(next_stop_name)) / 1000 / bus_velocity * 60;
-        edge_time_res += bus_edge_time_minutes;
+    edges.push_back(make_pair(EdgeType::bus_edge, make_unique<BusRouteItem>(bus_name, weight_scale->ToMinutes(edge_weight), span_count)));
+}
+
+void Database::AddBusEdges(const string &bus_name, const vector<size_t> &bus_stop_ids, bool is_backward) {
+    const size_t stops_count = bus_stop_ids.size();
+    auto stop_at = [&](size_t idx) {
+        return bus_stop_ids[is_backward ? stops_count - 1 - idx : idx];
+    };
+
+    for (size_t i = 0; i + 1 < stops_count; i++) {
+        RouteWeight edge_weight = 0;
+        for (size_t j = i + 1; j < stops_count; j++) {
+            // ребра от "остановки в маршруте" до "остановки в маршруте", время копится по мере удаления j
+            edge_weight += weight_scale->FromRideMeters(road_distances.Get(stop_at(j - 1), stop_at(j)));
+            AddBusEdge(bus_name, stop_at(i), stop_at(j), edge_weight, j - i);
+        }
     }
+}
 
-    size_t bus_edge_id = graph->AddEdge({stops.at(stops_in_bus.at(from_stop_idx)).id_in_graph + 1, stops.at(stops_in_bus.at(to_stop_idx)).id_in_graph, edge_time_res});
+void Database::AddWalkEdges(double walking_radius, double walking_velocity) {
+    vector<Coords> stops_coords;
+    stops_coords.reserve(stops_by_id.size());
+    for (const auto *stop_it : stops_by_id) {
+        stops_coords.push_back(stop_it->second.coords);
+    }
 
-    edges.push_back(make_pair(EdgeType::bus_edge, make_unique<BusRouteItem>(bus_name, edge_time_res, to_stop_idx - from_stop_idx)));
+    for (const auto &[from_id, to_id, meters] : FindStopPairsWithin(stops_coords, walking_radius)) {
+        const RouteWeight edge_weight = weight_scale->FromWalkMeters(meters, walking_velocity);
+        graph->AddEdge({stops_by_id[from_id]->second.id_in_graph, stops_by_id[to_id]->second.id_in_graph, edge_weight});
+        edges.push_back(make_pair(EdgeType::walk_edge, make_unique<WalkRouteItem>(
+                stops_by_id[from_id]->first, stops_by_id[to_id]->first, weight_scale->ToMinutes(edge_weight))));
+    }
+}
+
+void Database::CollapseParallelEdges() {
+    Graph::CollapsedGraph<RouteWeight> collapsed = Graph::CollapseParallelEdges(*graph);
+
+    vector<pair<EdgeType, unique_ptr<RouteItem>>> kept_edges;
+    kept_edges.reserve(collapsed.original_edges.size());
+    for (Graph::EdgeId original_edge_id : collapsed.original_edges) {
+        kept_edges.push_back(move(edges[original_edge_id]));
+    }
+    parallel_edge_items.clear();
+    parallel_edge_items.reserve(collapsed.dropped_edges.Size());
+    for (Graph::EdgeId original_edge_id : collapsed.dropped_edges.original_edges) {
+        parallel_edge_items.push_back(move(edges[original_edge_id]));
+    }
+
+    edges = move(kept_edges);
+    parallel_edges = move(collapsed.dropped_edges);
+    *graph = move(collapsed.graph);
 }
 
 
 void Database::FillRoutesGraph(const RoutingSettings &routing_settings) {
-    graph = make_unique<Graph::DirectedWeightedGraph<double>>(stops.size() * 2);
+    FinishFill();
+    weight_scale = RouteWeightScale(routing_settings);
+    graph = make_unique<Graph::DirectedWeightedGraph<RouteWeight>>(stops.size() * 2);
+    edges.clear();
 
     // fill id_in_graph for stops
+    stop_names_in_graph.clear();
     for (auto[i, it] = make_tuple(0, stops.begin()); it != stops.end(); it++, i += 2) {
         it->second.id_in_graph = i;
+        stop_names_in_graph.push_back(&it->first);
 
         AddEdgeFromStop(i, it->first, routing_settings.bus_wait_time);
     }
 
     for (const auto&[bus_name, bus] : buses) {
-
-        for (size_t i = 0; i < bus.stops.size() - 1; i++) {
-            for (size_t j = i + 1; j < bus.stops.size(); j++) {
-                // ребра от "остановки в маршруте" до "остановки в маршруте"
-                AddBusEdge(bus_name, bus.stops, i, j, routing_settings.bus_velocity);
-            }
+        AddBusEdges(bus_name, bus.stops, false);
+        if (!bus.is_roundtrip) {
+            // the way back is a separate direction, no edges ride through the last stop
+            AddBusEdges(bus_name, bus.stops, true);
         }
     }
+    if (routing_settings.walking_radius) {
+        AddWalkEdges(*routing_settings.walking_radius, routing_settings.walking_velocity);
+    }
+    CollapseParallelEdges();
 
-    router = make_unique<Graph::Router<double>>(*graph);
+    router.reset();
+    lazy_router.reset();
+    if (routing_settings.lazy_router_memory_budget_bytes) {
+        lazy_router = make_unique<Graph::LazyRouter<RouteWeight>>(*graph, *routing_settings.lazy_router_memory_budget_bytes);
+    } else {
+        router = make_unique<Graph::Router<RouteWeight>>(*graph);
+    }
+    alternative_routes_finder = make_unique<Graph::AlternativeRoutesFinder<RouteWeight>>(*graph, &parallel_edges);
 }
 
 
@@ -128,6 +229,22 @@ const Database::Stop *Database::GetStopInfo(const std::string &stop_name) const
     }
 }
 
+size_t Database::GetStopCount() const {
+    return stops.size();
+}
+
+size_t Database::BusStatsColumns::Append(const Database::BusStats &stats) {
+    num_stops.push_back(stats.num_stops);
+    num_unique_stops.push_back(stats.num_unique_stops);
+    calculated_length.push_back(stats.bus_calculated_length);
+    real_length.push_back(stats.bus_real_length);
+    return num_stops.size() - 1;
+}
+
+Database::BusStats Database::BusStatsColumns::Get(size_t bus_id) const {
+    return {num_stops[bus_id], num_unique_stops[bus_id], calculated_length[bus_id], real_length[bus_id]};
+}
+
 const Database::Bus *Database::GetBusInfo(const std::string &bus_name) const {
     auto it = buses.find(bus_name);
     if (it == buses.end()) {
@@ -137,40 +254,217 @@ const Database::Bus *Database::GetBusInfo(const std::string &bus_name) const {
     }
 }
 
-std::optional<Database::RouteInfoRes> Database::GetRouteInfo(const std::string &stop_from, const std::string &stop_to) const {
-    std::optional<typename Graph::Router<double>::RouteInfo> route_info = router->BuildRoute(stops.at(stop_from).id_in_graph,
-                                                                                             stops.at(stop_to).id_in_graph);
-    if (!route_info.has_value()) {
+std::optional<Database::BusStats> Database::GetBusStats(const std::string &bus_name) const {
+    auto it = buses.find(bus_name);
+    if (it == buses.end()) {
         return nullopt;
     }
-    vector<unique_ptr<RouteItem>> res;
-    int current_edge_idx = 0;
-    while (current_edge_idx < route_info->edge_count) {
-        size_t edge_id = router->GetRouteEdge(route_info->id, current_edge_idx++);
-
-        switch (edges[edge_id].first) {
-            case EdgeType::from_stop: {
-                unique_ptr<WaitRouteItem> item_ptr = make_unique<WaitRouteItem>(dynamic_cast<WaitRouteItem &>(*edges[edge_id].second));
-                res.push_back(move(item_ptr));
-                break;
+    return bus_stats.Get(it->second.id);
+}
+
+namespace {
+
+    constexpr size_t MIN_ROWS_PER_EXPORT_CHUNK = 4096;
+
+    void WriteCsvField(ostream &os, const string &field) {
+        if (field.find_first_of(",\"\n") == string::npos) {
+            os << field;
+            return;
+        }
+        os << '"';
+        for (char c : field) {
+            os << c;
+            if (c == '"') {
+                os << '"';
             }
-            case EdgeType::bus_edge: {
-                unique_ptr<BusRouteItem> item_ptr = make_unique<BusRouteItem>(dynamic_cast<BusRouteItem &>(*edges[edge_id].second));
-                res.push_back(move(item_ptr));
-                break;
+        }
+        os << '"';
+    }
+
+    // format rows [0, row_count) with format_row(ostream&, row_idx), splitting them between threads
+    template<typename RowFormatter>
+    size_t ExportRowsParallel(ostream &os, size_t row_count, RowFormatter format_row) {
+        const size_t chunk_count = max<size_t>(1, min<size_t>(thread::hardware_concurrency(), row_count / MIN_ROWS_PER_EXPORT_CHUNK));
+        const size_t chunk_size = (row_count + chunk_count - 1) / chunk_count;
+
+        vector<future<string>> chunks;
+        for (size_t chunk_begin = 0; chunk_begin < row_count; chunk_begin += chunk_size) {
+            const size_t chunk_end = min(row_count, chunk_begin + chunk_size);
+            chunks.push_back(async(chunk_count == 1 ? launch::deferred : launch::async, [chunk_begin, chunk_end, &format_row] {
+                ostringstream chunk_os;
+                chunk_os << setprecision(6);
+                for (size_t row_idx = chunk_begin; row_idx < chunk_end; ++row_idx) {
+                    format_row(chunk_os, row_idx);
+                }
+                return chunk_os.str();
+            }));
+        }
+
+        for (future<string> &chunk : chunks) {
+            os << chunk.get();
+        }
+        return row_count;
+    }
+
+}
+
+size_t Database::ExportBusStats(ostream &os, ExportFormat format) const {
+    if (format == ExportFormat::csv) {
+        os << "bus,stop_count,unique_stop_count,route_length,curvature\n";
+    }
+
+    return ExportRowsParallel(os, buses_by_id.size(), [this, format](ostream &row_os, size_t bus_id) {
+        const string &bus_name = buses_by_id[bus_id]->first;
+        const double curvature = bus_stats.real_length[bus_id] / bus_stats.calculated_length[bus_id];
+
+        if (format == ExportFormat::csv) {
+            WriteCsvField(row_os, bus_name);
+            row_os << ',' << bus_stats.num_stops[bus_id] << ',' << bus_stats.num_unique_stops[bus_id]
+                   << ',' << bus_stats.real_length[bus_id] << ',' << curvature << '\n';
+        } else {
+            row_os << "{\"bus\": ";
+            Json::WriteString(row_os, bus_name);
+            row_os << ", \"stop_count\": " << bus_stats.num_stops[bus_id]
+                   << ", \"unique_stop_count\": " << bus_stats.num_unique_stops[bus_id]
+                   << ", \"route_length\": " << bus_stats.real_length[bus_id]
+                   << ", \"curvature\": " << curvature << "}\n";
+        }
+    });
+}
+
+size_t Database::ExportStopBuses(ostream &os, ExportFormat format) const {
+    if (format == ExportFormat::csv) {
+        os << "stop,buses\n";
+    }
+
+    return ExportRowsParallel(os, stops_by_id.size(), [this, format](ostream &row_os, size_t stop_id) {
+        const auto &[stop_name, stop] = *stops_by_id[stop_id];
+
+        if (format == ExportFormat::csv) {
+            // buses are joined into a single field with ';'
+            string buses_field;
+            for (const string &bus_name : stop.stop_in_buses) {
+                if (!buses_field.empty()) {
+                    buses_field += ';';
+                }
+                buses_field += bus_name;
+            }
+            WriteCsvField(row_os, stop_name);
+            row_os << ',';
+            WriteCsvField(row_os, buses_field);
+            row_os << '\n';
+        } else {
+            row_os << "{\"stop\": ";
+            Json::WriteString(row_os, stop_name);
+            row_os << ", \"buses\": [";
+            for (auto it = stop.stop_in_buses.begin(); it != stop.stop_in_buses.end(); ++it) {
+                if (it != stop.stop_in_buses.begin()) {
+                    row_os << ", ";
+                }
+                Json::WriteString(row_os, *it);
             }
-            default:
-                throw runtime_error("");
+            row_os << "]}\n";
+        }
+    });
+}
+
+std::optional<Database::RouteInfoRes> Database::GetRouteInfo(const std::string &stop_from, const std::string &stop_to) const {
+    const Graph::VertexId vertex_from = stops.at(stop_from).id_in_graph;
+    const Graph::VertexId vertex_to = stops.at(stop_to).id_in_graph;
+
+    // routes are short (wait, bus, wait, bus...), so edges fit on the stack, the heap is only a fallback
+    array<Graph::EdgeId, 64> route_edges_buffer;
+    vector<Graph::EdgeId> long_route_edges;
+    Graph::EdgeId *route_edges = route_edges_buffer.data();
+
+    auto route_summary = BuildRouteInto(vertex_from, vertex_to, route_edges, route_edges_buffer.size());
+    if (!route_summary.has_value()) {
+        return nullopt;
+    }
+    if (route_summary->edge_count > route_edges_buffer.size()) {
+        long_route_edges.resize(route_summary->edge_count);
+        route_edges = long_route_edges.data();
+        BuildRouteInto(vertex_from, vertex_to, route_edges, long_route_edges.size());
+    }
+
+    vector<unique_ptr<RouteItem>> res;
+    res.reserve(route_summary->edge_count);
+    for (size_t edge_idx = 0; edge_idx < route_summary->edge_count; ++edge_idx) {
+        res.push_back(MakeRouteItem(route_edges[edge_idx]));
+    }
+    return Database::RouteInfoRes{move(res), weight_scale->ToMinutes(route_summary->weight)};
+}
+
+std::optional<std::vector<Database::ReachedStop>> Database::GetReachableStops(const std::string &stop_from, double max_time) const {
+    auto it = stops.find(stop_from);
+    if (it == stops.end()) {
+        return nullopt;
+    }
+
+    vector<ReachedStop> res;
+    for (const auto &[vertex, weight] : Graph::FindReachableVertices(*graph, it->second.id_in_graph, weight_scale->FromMinutesFloor(max_time))) {
+        if (vertex % 2 == 0) {  // stop vertex, odd ones are "waited at the stop"
+            res.push_back({stop_names_in_graph[vertex / 2], weight_scale->ToMinutes(weight)});
         }
+    }
+    return res;
+}
+
+std::vector<Database::RouteInfoRes> Database::GetAlternativeRoutesInfo(const std::string &stop_from, const std::string &stop_to,
+                                                                      size_t max_count, double diversity) const {
+    vector<RouteInfoRes> res;
+    auto from_it = stops.find(stop_from);
+    auto to_it = stops.find(stop_to);
+    if (from_it == stops.end() || to_it == stops.end()) {
+        return res;
+    }
 
+    vector<Graph::AlternativeRoutesFinder<RouteWeight>::Route> routes = alternative_routes_finder->FindRoutes(
+            from_it->second.id_in_graph, to_it->second.id_in_graph, max_count, diversity);
+    for (const auto &route : routes) {
+        vector<unique_ptr<RouteItem>> items;
+        for (Graph::EdgeId edge_id : route.edges) {
+            items.push_back(MakeRouteItem(edge_id));
+        }
+        res.push_back({move(items), weight_scale->ToMinutes(route.weight)});
     }
+    return res;
+}
 
-    router->ReleaseRoute(route_info->id);
-    return Database::RouteInfoRes{move(res), route_info->weight};
+std::optional<Graph::RouteSummary<RouteWeight>> Database::BuildRouteInto(Graph::VertexId from, Graph::VertexId to,
+                                                                         Graph::EdgeId *edges_out, size_t capacity) const {
+    return lazy_router ? lazy_router->BuildRouteInto(from, to, edges_out, capacity)
+                       : router->BuildRouteInto(from, to, edges_out, capacity);
 }
 
-size_t Database::CalculateUniqueStops(const vector<std::string> &stops) {
-    set<string> stops_set(begin(stops), end(stops));
-    return stops_set.size();
+unique_ptr<RouteItem> Database::MakeRouteItem(Graph::EdgeId edge_id) const {
+    const auto &[edge_type, item] = edge_id < edges.size() ? edges[edge_id] : parallel_edge_items[edge_id - edges.size()];
+    switch (edge_type) {
+        case EdgeType::from_stop:
+            return make_unique<WaitRouteItem>(dynamic_cast<WaitRouteItem &>(*item));
+        case EdgeType::bus_edge:
+            return make_unique<BusRouteItem>(dynamic_cast<BusRouteItem &>(*item));
+        case EdgeType::walk_edge:
+            return make_unique<WalkRouteItem>(dynamic_cast<WalkRouteItem &>(*item));
+        default:
+            throw runtime_error("");
+    }
 }
 
+size_t Database::CalculateUniqueStops(const vector<size_t> &bus_stop_ids) {
+    unique_stops_bitmap.resize(stops.size());
+
+    size_t unique_count = 0;
+    for (size_t stop_id : bus_stop_ids) {
+        if (!unique_stops_bitmap[stop_id]) {
+            unique_stops_bitmap[stop_id] = true;
+            ++unique_count;
+        }
+    }
+
+    // reset only the bits we set, so the bitmap is reused without an O(stops) clear per bus
+    for (size_t stop_id : bus_stop_ids) {
+        unique_stops_bitmap[stop_id] = false;
+    }
+    return unique_count;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+#include <ostream>
 #include <set>
 #include <string>
 #include <utility>
@@ -7,10 +9,16 @@
 #include <unordered_map>
 
 
+#include "alternative_routes.h"
 #include "coords.h"
 #include "graph.h"
+#include "lazy_router.h"
+#include "parallel_edges.h"
+#include "reachability.h"
 #include "requests_input.h"
+#include "road_distances.h"
 #include "route_query_result.h"
+#include "route_weight.h"
 #include "router.h"
 #include "routing_settings.h"
 
@@ -19,23 +27,35 @@ class Database {
 public:
     struct Stop {
         Coords coords;
-        std::unordered_map<std::string, double> distances;
         std::set<std::string> stop_in_buses;
+        size_t id;
         size_t id_in_graph;
-
-        double GetDistanceTo(const std::string &this_stop_name, const std::string &to_stop_name, const Stop &to_stop) const;
     };
 
     struct Bus {
-        std::vector<std::string> stops;
+        size_t id;
+        std::vector<size_t> stops;  // Stop::id, one direction only, a linear bus then goes back over them
+        bool is_roundtrip;
+    };
+
+    struct BusStats {
         size_t num_stops;
         size_t num_unique_stops;
         double bus_calculated_length;
         double bus_real_length;
     };
 
+    enum class ExportFormat {
+        csv, ndjson
+    };
+
     enum class EdgeType {
-        from_stop, bus_edge
+        from_stop, bus_edge, walk_edge
+    };
+
+    struct ReachedStop {
+        const std::string *stop_name;
+        double time;
     };
 
     struct RouteInfoRes {
@@ -46,35 +66,112 @@ public:
 public:
     void AddStop(std::string name, Coords coords, std::unordered_map<std::string, double> distances);
 
-    void AddBus(std::string bus_name, std::vector<std::string> stops_to_add);
+    void AddBus(std::string bus_name, std::vector<std::string> stops_to_add, bool is_roundtrip);
+
+    // stop_ids are Stop::id of stops added already
+    void AddBus(std::string bus_name, std::vector<size_t> stop_ids, bool is_roundtrip);
 
     void ApplyFillRequests(DbInputRequests requests);
 
+    // Builds the road distance table once all stops are in and computes the route length of every bus
+    // in one pass over it. Called by ApplyFillRequests and FillRoutesGraph, does nothing if no stop or bus
+    // was added since the last call; route lengths in bus stats are valid only after it.
+    void FinishFill();
+
     void FillRoutesGraph(const RoutingSettings &routing_settings);
 
     const Stop *GetStopInfo(const std::string &stop_name) const;
 
+    size_t GetStopCount() const;
+
     const Bus *GetBusInfo(const std::string &bus_name) const;
 
+    std::optional<BusStats> GetBusStats(const std::string &bus_name) const;
+
+    // Write one row per bus (in insertion order) with stop_count, unique_stop_count, route_length and curvature.
+    // Rows are formatted in parallel chunks and written in order. Returns the number of rows.
+    size_t ExportBusStats(std::ostream &os, ExportFormat format) const;
+
+    // Write one row per stop (in insertion order) with the sorted list of its buses. Returns the number of rows.
+    size_t ExportStopBuses(std::ostream &os, ExportFormat format) const;
+
     std::optional<RouteInfoRes> GetRouteInfo(const std::string &stop_from, const std::string &stop_to) const;
 
+    // stops reachable from stop_from within max_time minutes (waiting at stop_from included), ordered by time
+    std::optional<std::vector<ReachedStop>> GetReachableStops(const std::string &stop_from, double max_time) const;
+
+    // up to max_count diverse routes ordered by time, see Graph::AlternativeRoutesFinder; none for an unknown stop
+    std::vector<RouteInfoRes> GetAlternativeRoutesInfo(const std::string &stop_from, const std::string &stop_to,
+                                                       size_t max_count, double diversity) const;
+
 private:
 
 
     std::unordered_map<std::string, Stop> stops;
     std::unordered_map<std::string, Bus> buses;
 
-    std::unique_ptr<Graph::DirectedWeightedGraph<double>> graph;
-    std::unique_ptr<Graph::Router<double>> router;
+    std::vector<std::pair<const std::string, Stop> *> stops_by_id;
+    std::vector<const std::pair<const std::string, Bus> *> buses_by_id;
+
+    // per-bus aggregates stored column-wise and indexed by Bus::id,
+    // so stat lookups never touch the stops list of a bus
+    struct BusStatsColumns {
+        std::vector<size_t> num_stops;
+        std::vector<size_t> num_unique_stops;
+        std::vector<double> calculated_length;
+        std::vector<double> real_length;
+
+        size_t Append(const BusStats &stats);
+
+        BusStats Get(size_t bus_id) const;
+    } bus_stats;
+
+    struct PendingRoadDistance {
+        size_t from_stop_id;
+        std::string to_stop_name;
+        double meters;
+    };
+    std::vector<PendingRoadDistance> pending_road_distances;  // to_stop_name was not added by the last FinishFill
+    std::vector<RoadDistanceTable::Entry> road_distance_entries;
+    RoadDistanceTable road_distances;
+    bool is_fill_finished = true;
+
+    std::vector<bool> unique_stops_bitmap;  // indexed by Stop::id, all false between AddBus calls
+
+    std::optional<RouteWeightScale> weight_scale;
+    std::unique_ptr<Graph::DirectedWeightedGraph<RouteWeight>> graph;
+    std::unique_ptr<Graph::Router<RouteWeight>> router;  // exactly one of router and lazy_router is built
+    std::unique_ptr<Graph::LazyRouter<RouteWeight>> lazy_router;
+    std::unique_ptr<Graph::AlternativeRoutesFinder<RouteWeight>> alternative_routes_finder;
     std::vector<std::pair<EdgeType, std::unique_ptr<RouteItem>>> edges;
+    // side table of the collapsed parallel edges, with their route items (other buses on the same stretch)
+    // by index in parallel_edges, so alternative routes can still ride them
+    Graph::ParallelEdgeTable<RouteWeight> parallel_edges;
+    std::vector<std::pair<EdgeType, std::unique_ptr<RouteItem>>> parallel_edge_items;
+    std::vector<const std::string *> stop_names_in_graph;  // stop name by id_in_graph / 2
+
+    double CalculateCoordsLength(const std::vector<size_t> &bus_stop_ids, bool is_roundtrip) const;
+
+    double CalculateRealLength(const std::vector<size_t> &bus_stop_ids, bool is_roundtrip) const;
 
-    double CalculateCoordsLength(const std::vector<std::string> &bus_stops) const;
+    std::optional<Graph::RouteSummary<RouteWeight>> BuildRouteInto(Graph::VertexId from, Graph::VertexId to,
+                                                                   Graph::EdgeId *edges_out, size_t capacity) const;
 
-    double CalculateRealLength(const std::vector<std::string> &bus_stops) const;
+    // edge_id is a graph edge id, or graph->GetEdgeCount() + i for the i-th collapsed parallel edge
+    std::unique_ptr<RouteItem> MakeRouteItem(Graph::EdgeId edge_id) const;
 
     void AddEdgeFromStop(size_t vertex_id_stop, const std::string &stop_name, int bus_wait_time);
 
-    void AddBusEdge(const std::string &bus_name, const std::vector<std::string>& stops_in_bus, size_t from_stop_idx, size_t to_stop_idx, int bus_velocity);
+    void AddBusEdge(const std::string &bus_name, size_t from_stop_id, size_t to_stop_id, RouteWeight edge_weight, size_t span_count);
+
+    void AddBusEdges(const std::string &bus_name, const std::vector<size_t> &bus_stop_ids, bool is_backward);
+
+    // keep only the lightest of parallel edges in the graph and the others in the side table,
+    // see Graph::CollapseParallelEdges
+    void CollapseParallelEdges();
+
+    // stop-to-stop edges between "arrived at stop" vertices, so a walk is followed by the usual wait
+    void AddWalkEdges(double walking_radius, double walking_velocity);
 
-    static size_t CalculateUniqueStops(const std::vector<std::string> &stops);
+    size_t CalculateUniqueStops(const std::vector<size_t> &bus_stop_ids);
 };
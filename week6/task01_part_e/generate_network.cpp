@@ -0,0 +1,26 @@
+#include <iostream>
+#include <string>
+
+#include "synthetic_network.h"
+
+using namespace std;
+
+
+// Usage: generate_network [stop_count] [bus_count] [stat_request_count] [seed] > input.json
+int main(int argc, char *argv[]) {
+    SyntheticNetworkParams params;
+    if (argc > 1) {
+        params.stop_count = stoul(argv[1]);
+    }
+    if (argc > 2) {
+        params.bus_count = stoul(argv[2]);
+    }
+    if (argc > 3) {
+        params.stat_request_count = stoul(argv[3]);
+    }
+    if (argc > 4) {
+        params.seed = stoul(argv[4]);
+    }
+
+    cout << GenerateSyntheticNetworkJson(params);
+}
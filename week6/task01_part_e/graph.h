@@ -32,6 +32,13 @@ namespace Graph {
         Weight weight;
     };
 
+    // weight and length of a route written into a caller buffer by Router/LazyRouter::BuildRouteInto
+    template<typename Weight>
+    struct RouteSummary {
+        Weight weight;
+        size_t edge_count;
+    };
+
     template<typename Weight>
     class DirectedWeightedGraph {
     private:
@@ -0,0 +1,57 @@
+#include "input_buffer.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INPUT_BUFFER_HAS_MMAP
+#endif
+
+using namespace std;
+
+
+InputBuffer::InputBuffer(const string &file_name) {
+#ifdef INPUT_BUFFER_HAS_MMAP
+    const int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("cannot open input file " + file_name);
+    }
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        void *data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, static_cast<size_t>(file_stat.st_size), MADV_SEQUENTIAL);
+            mapped_data = static_cast<const char *>(data);
+            mapped_size = static_cast<size_t>(file_stat.st_size);
+        }
+    }
+    close(fd);
+    if (mapped_data) {
+        return;
+    }
+#endif
+
+    ifstream input(file_name, ios::binary | ios::ate);
+    if (!input) {
+        throw runtime_error("cannot open input file " + file_name);
+    }
+    owned_data.resize(static_cast<size_t>(input.tellg()));
+    input.seekg(0);
+    input.read(owned_data.data(), static_cast<streamsize>(owned_data.size()));
+}
+
+InputBuffer::~InputBuffer() {
+#ifdef INPUT_BUFFER_HAS_MMAP
+    if (mapped_data) {
+        munmap(const_cast<char *>(mapped_data), mapped_size);
+    }
+#endif
+}
+
+string_view InputBuffer::View() const {
+    return mapped_data ? string_view(mapped_data, mapped_size) : string_view(owned_data);
+}
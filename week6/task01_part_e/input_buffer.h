@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+
+// Whole file contents as one read-only buffer: memory-mapped where mmap is available,
+// otherwise (or if mapping fails) read with a single read call into an owned string.
+class InputBuffer {
+public:
+    explicit InputBuffer(const std::string &file_name);
+
+    InputBuffer(const InputBuffer &) = delete;
+
+    InputBuffer &operator=(const InputBuffer &) = delete;
+
+    ~InputBuffer();
+
+    std::string_view View() const;
+
+private:
+    const char *mapped_data = nullptr;
+    size_t mapped_size = 0;
+    std::string owned_data;
+};
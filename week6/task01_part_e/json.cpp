@@ -1,5 +1,12 @@
 #include "json.h"
 
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <stdexcept>
+
+#include "json_scan.h"
+
 using namespace std;
 
 namespace Json {
@@ -87,4 +94,309 @@ namespace Json {
         return Document{LoadNode(input)};
     }
 
+    namespace {
+
+        // Stage 2: walks the structural index instead of the bytes, so whitespace and
+        // string bodies are never touched char by char through istream.
+        // The index is built for one block of the input at a time, so it stays small for any input size.
+        class StructuralLoader {
+        public:
+            explicit StructuralLoader(string_view input) : input(input) {}
+
+            // elements of the array under streamed_key in the root object go to on_element instead of the document
+            Node LoadDocumentRoot(string_view streamed_key = {}, const function<void(Node)> *on_element = nullptr) {
+                Node root;
+                if (on_element && IsNextStructural('{')) {
+                    TakeStructural();
+                    root = LoadDict(streamed_key, on_element);
+                } else {
+                    root = LoadValue();
+                }
+                if (!IsBlank(input.substr(cursor))) {
+                    throw invalid_argument("unexpected data after json root");
+                }
+                return root;
+            }
+
+        private:
+            static constexpr size_t INDEX_BLOCK_SIZE = 1 << 16;
+
+            string_view input;
+            vector<uint32_t> structurals;  // offsets from block_begin
+            size_t block_begin = 0;
+            size_t block_end = 0;  // the input is indexed up to here
+            size_t next_structural = 0;
+            size_t cursor = 0;
+
+            static bool IsBlank(string_view s) {
+                return s.find_first_not_of(" \t\n\r") == string_view::npos;
+            }
+
+            static string_view Trim(string_view s) {
+                const size_t first = s.find_first_not_of(" \t\n\r");
+                if (first == string_view::npos) {
+                    return {};
+                }
+                return s.substr(first, s.find_last_not_of(" \t\n\r") - first + 1);
+            }
+
+            size_t PeekStructuralPos() {
+                while (next_structural == structurals.size() && block_end < input.size()) {
+                    block_begin = block_end;
+                    block_end = min(input.size(), block_begin + INDEX_BLOCK_SIZE);
+                    structurals = FindStructuralIndices(input.substr(block_begin, block_end - block_begin));
+                    next_structural = 0;
+                }
+                return next_structural < structurals.size() ? block_begin + structurals[next_structural] : input.size();
+            }
+
+            char TakeStructural() {
+                const size_t pos = PeekStructuralPos();
+                if (pos == input.size() || !IsBlank(input.substr(cursor, pos - cursor))) {
+                    throw invalid_argument("json structural character expected");
+                }
+                ++next_structural;
+                cursor = pos + 1;
+                return input[pos];
+            }
+
+            bool IsNextStructural(char c) {
+                const size_t pos = PeekStructuralPos();
+                return pos < input.size() && input[pos] == c && IsBlank(input.substr(cursor, pos - cursor));
+            }
+
+            Node LoadValue() {
+                const size_t pos = PeekStructuralPos();
+                const string_view scalar = Trim(input.substr(cursor, pos - cursor));
+                if (!scalar.empty()) {
+                    cursor = pos;
+                    return LoadScalar(scalar);
+                }
+
+                switch (TakeStructural()) {
+                    case '[':
+                        return LoadArray();
+                    case '{':
+                        return LoadDict();
+                    case '"':
+                        return Node(LoadString());
+                    default:
+                        throw invalid_argument("json value expected");
+                }
+            }
+
+            Node LoadArray() {
+                vector<Node> result;
+                if (IsNextStructural(']')) {
+                    TakeStructural();
+                    return Node(move(result));
+                }
+
+                for (char c = ','; c == ',';) {
+                    result.push_back(LoadValue());
+                    c = TakeStructural();
+                    if (c != ',' && c != ']') {
+                        throw invalid_argument("',' or ']' expected in json array");
+                    }
+                }
+                return Node(move(result));
+            }
+
+            // the value under streamed_key, if an array, is passed to on_element element by element and left empty
+            Node LoadDict(string_view streamed_key = {}, const function<void(Node)> *on_element = nullptr) {
+                map<string, Node> result;
+                if (IsNextStructural('}')) {
+                    TakeStructural();
+                    return Node(move(result));
+                }
+
+                for (char c = ','; c == ',';) {
+                    if (TakeStructural() != '"') {
+                        throw invalid_argument("string key expected in json object");
+                    }
+                    string key = LoadString();
+                    if (TakeStructural() != ':') {
+                        throw invalid_argument("':' expected in json object");
+                    }
+                    if (on_element && key == streamed_key && IsNextStructural('[')) {
+                        TakeStructural();
+                        StreamArray(*on_element);
+                        result.emplace(move(key), Node(vector<Node>{}));
+                    } else {
+                        result.emplace(move(key), LoadValue());
+                    }
+                    c = TakeStructural();
+                    if (c != ',' && c != '}') {
+                        throw invalid_argument("',' or '}' expected in json object");
+                    }
+                }
+                return Node(move(result));
+            }
+
+            // opening bracket is already taken
+            void StreamArray(const function<void(Node)> &on_element) {
+                if (IsNextStructural(']')) {
+                    TakeStructural();
+                    return;
+                }
+
+                for (char c = ','; c == ',';) {
+                    on_element(LoadValue());
+                    c = TakeStructural();
+                    if (c != ',' && c != ']') {
+                        throw invalid_argument("',' or ']' expected in json array");
+                    }
+                }
+            }
+
+            // opening quote is already taken; structurals inside the string are skipped here
+            string LoadString() {
+                bool has_escapes = false;
+                for (size_t pos; (pos = PeekStructuralPos()) < input.size(); ++next_structural) {
+                    if (input[pos] == '\\') {
+                        has_escapes = true;
+                        continue;
+                    }
+                    if (input[pos] != '"' || IsEscaped(pos)) {
+                        continue;
+                    }
+
+                    const string_view raw = input.substr(cursor, pos - cursor);
+                    ++next_structural;
+                    cursor = pos + 1;
+                    return has_escapes ? Unescape(raw) : string(raw);
+                }
+                throw invalid_argument("unterminated json string");
+            }
+
+            bool IsEscaped(size_t quote_pos) const {
+                size_t backslashes = 0;
+                while (quote_pos - backslashes > cursor && input[quote_pos - backslashes - 1] == '\\') {
+                    ++backslashes;
+                }
+                return backslashes % 2 == 1;
+            }
+
+            static string Unescape(string_view raw) {
+                string res;
+                res.reserve(raw.size());
+                for (size_t i = 0; i < raw.size(); ++i) {
+                    if (raw[i] != '\\' || i + 1 == raw.size()) {
+                        res.push_back(raw[i]);
+                        continue;
+                    }
+                    switch (raw[++i]) {
+                        case 'n':
+                            res.push_back('\n');
+                            break;
+                        case 't':
+                            res.push_back('\t');
+                            break;
+                        case 'r':
+                            res.push_back('\r');
+                            break;
+                        case 'b':
+                            res.push_back('\b');
+                            break;
+                        case 'f':
+                            res.push_back('\f');
+                            break;
+                        case 'u':  // not decoded, kept as is
+                            res.push_back('\\');
+                            res.push_back('u');
+                            break;
+                        default:  // '"', '\\' and '/'
+                            res.push_back(raw[i]);
+                    }
+                }
+                return res;
+            }
+
+            static Node LoadScalar(string_view scalar) {
+                if (scalar == "true") {
+                    return Node(true);
+                }
+                if (scalar == "false") {
+                    return Node(false);
+                }
+
+                double result;
+                const auto[ptr, ec] = from_chars(scalar.data(), scalar.data() + scalar.size(), result);
+                if (ec != errc() || ptr != scalar.data() + scalar.size()) {
+                    throw invalid_argument("bad json scalar: " + string(scalar));
+                }
+                return Node(result);
+            }
+        };
+
+    }
+
+    Document Load(string_view input) {
+        return Document{StructuralLoader(input).LoadDocumentRoot()};
+    }
+
+    namespace {
+
+        void WriteEscaped(ostream &output, string_view str) {
+            size_t plain_begin = 0;
+            for (size_t i = 0; i < str.size(); ++i) {
+                const unsigned char c = static_cast<unsigned char>(str[i]);
+                if (c >= 0x20 && c != '"' && c != '\\') {
+                    continue;
+                }
+                output.write(str.data() + plain_begin, static_cast<streamsize>(i - plain_begin));
+                plain_begin = i + 1;
+                switch (c) {
+                    case '"':
+                        output << "\\\"";
+                        break;
+                    case '\\':
+                        output << "\\\\";
+                        break;
+                    case '\n':
+                        output << "\\n";
+                        break;
+                    case '\r':
+                        output << "\\r";
+                        break;
+                    case '\t':
+                        output << "\\t";
+                        break;
+                    default: {
+                        const char hex_digits[] = "0123456789abcdef";
+                        output << "\\u00" << hex_digits[c >> 4] << hex_digits[c & 0xf];
+                    }
+                }
+            }
+            output.write(str.data() + plain_begin, static_cast<streamsize>(str.size() - plain_begin));
+        }
+
+    }
+
+    void WriteString(ostream &output, string_view str) {
+        output << '"';
+        WriteEscaped(output, str);
+        output << '"';
+    }
+
+    StringEscapeBuf::StringEscapeBuf(ostream &output) : output(output) {
+    }
+
+    StringEscapeBuf::int_type StringEscapeBuf::overflow(int_type c) {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            const char ch = traits_type::to_char_type(c);
+            WriteEscaped(output, string_view(&ch, 1));
+        }
+        return output ? traits_type::not_eof(c) : traits_type::eof();
+    }
+
+    streamsize StringEscapeBuf::xsputn(const char *s, streamsize count) {
+        WriteEscaped(output, string_view(s, static_cast<size_t>(count)));
+        return output ? count : 0;
+    }
+
+    Document LoadStreaming(string_view input, string_view streamed_key, const function<void(Node)> &on_element) {
+        return Document{StructuralLoader(input).LoadDocumentRoot(streamed_key, &on_element)};
+    }
+
 }
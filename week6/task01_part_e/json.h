@@ -1,8 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <istream>
 #include <map>
+#include <ostream>
+#include <streambuf>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -49,4 +53,29 @@ namespace Json {
 
     Document Load(std::istream &input);
 
+    // Parses an in-memory buffer using the structural index from FindStructuralIndices (json_scan.h)
+    Document Load(std::string_view input);
+
+    // Writes str as a JSON string literal, quotes included
+    void WriteString(std::ostream &output, std::string_view str);
+
+    // Stream buffer that writes everything put into it to output escaped as the inside of a JSON string,
+    // so text formatted by ostream code goes into a string literal without an intermediate copy
+    class StringEscapeBuf : public std::streambuf {
+    public:
+        explicit StringEscapeBuf(std::ostream &output);
+
+    protected:
+        int_type overflow(int_type c) override;
+
+        std::streamsize xsputn(const char *s, std::streamsize count) override;
+
+    private:
+        std::ostream &output;
+    };
+
+    // Same as Load(string_view), but if the root is an object, the elements of the array under streamed_key
+    // are passed to on_element as soon as each is parsed and are not kept: the document has an empty array there
+    Document LoadStreaming(std::string_view input, std::string_view streamed_key, const std::function<void(Node)> &on_element);
+
 }
@@ -0,0 +1,99 @@
+#include "json_scan.h"
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace Json {
+
+    namespace {
+
+        constexpr array<bool, 256> STRUCTURAL_TABLE = [] {
+            array<bool, 256> table{};
+            for (unsigned char c : {'"', '\\', '{', '}', '[', ']', ':', ','}) {
+                table[c] = true;
+            }
+            return table;
+        }();
+
+        void ScanScalar(const char *data, size_t from, size_t to, vector<uint32_t> &res) {
+            for (size_t i = from; i < to; ++i) {
+                if (STRUCTURAL_TABLE[static_cast<unsigned char>(data[i])]) {
+                    res.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+
+#if defined(__AVX2__) || defined(__SSE2__)
+        void AppendMaskBits(uint32_t mask, size_t block_start, vector<uint32_t> &res) {
+            while (mask) {
+                res.push_back(static_cast<uint32_t>(block_start + __builtin_ctz(mask)));
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+#if defined(__AVX2__)
+        constexpr size_t BLOCK_SIZE = 32;
+
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}', so brackets and braces cost two compares instead of four
+        uint32_t StructuralMask(const char *block) {
+            const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+            const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+
+            __m256i hits = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"'));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')));
+            hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        }
+#elif defined(__SSE2__)
+        constexpr size_t BLOCK_SIZE = 16;
+
+        // '[' | 0x20 == '{' and ']' | 0x20 == '}', so brackets and braces cost two compares instead of four
+        uint32_t StructuralMask(const char *block) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+            const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+
+            __m128i hits = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+            return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        }
+#endif
+
+    }
+
+    vector<uint32_t> FindStructuralIndices(string_view input) {
+        if (input.size() > numeric_limits<uint32_t>::max()) {
+            throw length_error("json input is larger than 4 GiB");
+        }
+
+        vector<uint32_t> res;
+        res.reserve(input.size() / 8);
+
+        size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        for (; i + BLOCK_SIZE <= input.size(); i += BLOCK_SIZE) {
+            AppendMaskBits(StructuralMask(input.data() + i), i, res);
+        }
+#endif
+        ScanScalar(input.data(), i, input.size(), res);
+
+        return res;
+    }
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Json {
+
+    // Stage 1 of the buffer loader: byte offsets of every '"', '\\', '{', '}', '[', ']', ':' and ','.
+    // Scans 32 bytes at a time with AVX2, 16 with SSE2, and falls back to a lookup table otherwise.
+    // Characters inside strings are reported too, stage 2 skips them while reading the string.
+    std::vector<uint32_t> FindStructuralIndices(std::string_view input);
+
+}
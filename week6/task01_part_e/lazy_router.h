@@ -0,0 +1,146 @@
+#pragma once
+
+#include "graph.h"
+#include "monotone_queue.h"
+
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Graph {
+
+    // Router without the all-pairs table: the shortest path tree of a source is built by Dijkstra
+    // on its first query and kept in an LRU cache limited by memory_budget_bytes.
+    // Construction is O(1), memory follows the set of sources that are actually queried.
+    // Route weights are the same as Router's, but among equally heavy routes another one may be picked.
+    // Safe to query from several threads.
+    template<typename Weight>
+    class LazyRouter {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        LazyRouter(const Graph &graph, size_t memory_budget_bytes);
+
+        using RouteSummary = ::Graph::RouteSummary<Weight>;
+
+        // same contract as Router::BuildRouteInto
+        std::optional<RouteSummary> BuildRouteInto(VertexId from, VertexId to, EdgeId *edges_out, size_t capacity) const;
+
+    private:
+        static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+        struct RouteTree {
+            std::vector<Weight> weights;
+            std::vector<EdgeId> prev_edges;  // NO_EDGE for the source and unreachable vertices
+            std::vector<bool> reached;
+        };
+
+        const Graph &graph_;
+        size_t memory_budget_bytes_;
+
+        mutable std::mutex cache_mutex_;
+        mutable std::list<VertexId> lru_sources_;  // most recently used first
+        mutable std::unordered_map<VertexId, std::pair<std::shared_ptr<const RouteTree>, typename std::list<VertexId>::iterator>> trees_;
+
+        size_t TreeBytes() const {
+            return graph_.GetVertexCount() * (sizeof(Weight) + sizeof(EdgeId)) + graph_.GetVertexCount() / 8;
+        }
+
+        std::shared_ptr<const RouteTree> GetTree(VertexId from) const;
+
+        RouteTree BuildTree(VertexId from) const;
+    };
+
+
+    template<typename Weight>
+    LazyRouter<Weight>::LazyRouter(const Graph &graph, size_t memory_budget_bytes)
+            : graph_(graph), memory_budget_bytes_(memory_budget_bytes) {}
+
+    template<typename Weight>
+    std::optional<typename LazyRouter<Weight>::RouteSummary>
+    LazyRouter<Weight>::BuildRouteInto(VertexId from, VertexId to, EdgeId *edges_out, size_t capacity) const {
+        const std::shared_ptr<const RouteTree> tree = GetTree(from);
+        if (!tree->reached[to]) {
+            return std::nullopt;
+        }
+
+        size_t edge_count = 0;
+        for (EdgeId edge_id = tree->prev_edges[to]; edge_id != NO_EDGE; edge_id = tree->prev_edges[graph_.GetEdge(edge_id).from]) {
+            ++edge_count;
+        }
+
+        if (edge_count <= capacity) {
+            size_t edge_idx = edge_count;
+            for (EdgeId edge_id = tree->prev_edges[to]; edge_id != NO_EDGE; edge_id = tree->prev_edges[graph_.GetEdge(edge_id).from]) {
+                edges_out[--edge_idx] = edge_id;
+            }
+        }
+        return RouteSummary{tree->weights[to], edge_count};
+    }
+
+    template<typename Weight>
+    std::shared_ptr<const typename LazyRouter<Weight>::RouteTree> LazyRouter<Weight>::GetTree(VertexId from) const {
+        {
+            std::lock_guard<std::mutex> guard(cache_mutex_);
+            if (auto it = trees_.find(from); it != trees_.end()) {
+                lru_sources_.splice(lru_sources_.begin(), lru_sources_, it->second.second);
+                return it->second.first;
+            }
+        }
+
+        // built outside the lock, so queries from other sources are not blocked meanwhile
+        auto tree = std::make_shared<const RouteTree>(BuildTree(from));
+
+        std::lock_guard<std::mutex> guard(cache_mutex_);
+        if (auto it = trees_.find(from); it != trees_.end()) {  // another thread was faster
+            return it->second.first;
+        }
+        lru_sources_.push_front(from);
+        trees_.emplace(from, std::make_pair(tree, lru_sources_.begin()));
+        // the tree just built stays even if it alone exceeds the budget
+        while (trees_.size() > 1 && trees_.size() * TreeBytes() > memory_budget_bytes_) {
+            trees_.erase(lru_sources_.back());
+            lru_sources_.pop_back();
+        }
+        return tree;
+    }
+
+    template<typename Weight>
+    typename LazyRouter<Weight>::RouteTree LazyRouter<Weight>::BuildTree(VertexId from) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        RouteTree tree{std::vector<Weight>(vertex_count), std::vector<EdgeId>(vertex_count, NO_EDGE), std::vector<bool>(vertex_count)};
+        std::vector<bool> settled(vertex_count);
+
+        MonotoneQueue<Weight, VertexId> queue;
+        tree.reached[from] = true;
+        queue.Push(0, from);
+
+        while (!queue.Empty()) {
+            const auto[weight, vertex] = queue.Pop();
+            if (settled[vertex]) {
+                continue;
+            }
+            settled[vertex] = true;
+
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto &edge = graph_.GetEdge(edge_id);
+                const Weight candidate = weight + edge.weight;
+                if (!tree.reached[edge.to] || candidate < tree.weights[edge.to]) {
+                    tree.reached[edge.to] = true;
+                    tree.weights[edge.to] = candidate;
+                    tree.prev_edges[edge.to] = edge_id;
+                    queue.Push(candidate, edge.to);
+                }
+            }
+        }
+
+        return tree;
+    }
+
+}
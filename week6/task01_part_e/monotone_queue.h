@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Graph {
+
+    // Min-queue for Dijkstra-like searches: pushed keys are never smaller than the last popped one.
+    template<typename Key, typename Value>
+    class BinaryHeapQueue {
+    public:
+        void Push(Key key, Value value) {
+            heap_.push({key, value});
+        }
+
+        std::pair<Key, Value> Pop() {
+            std::pair<Key, Value> res = heap_.top();
+            heap_.pop();
+            return res;
+        }
+
+        bool Empty() const {
+            return heap_.empty();
+        }
+
+    private:
+        std::priority_queue<std::pair<Key, Value>, std::vector<std::pair<Key, Value>>, std::greater<>> heap_;
+    };
+
+
+    // Radix heap for non-negative integer keys: an item lives in the bucket of the highest bit where its key
+    // differs from the last popped key, so every item moves to lower buckets at most 64 times in total.
+    template<typename Key, typename Value>
+    class RadixHeapQueue {
+        static_assert(std::is_integral_v<Key>);
+
+    public:
+        void Push(Key key, Value value) {
+            buckets_[BucketOf(static_cast<uint64_t>(key))].push_back({key, value});
+            ++size_;
+        }
+
+        std::pair<Key, Value> Pop() {
+            if (buckets_[0].empty()) {
+                size_t bucket_idx = 1;
+                while (buckets_[bucket_idx].empty()) {
+                    ++bucket_idx;
+                }
+                std::vector<std::pair<Key, Value>> bucket = std::move(buckets_[bucket_idx]);
+                buckets_[bucket_idx].clear();
+
+                last_ = static_cast<uint64_t>(bucket.front().first);
+                for (const auto &item : bucket) {
+                    last_ = std::min(last_, static_cast<uint64_t>(item.first));
+                }
+                for (const auto &item : bucket) {
+                    buckets_[BucketOf(static_cast<uint64_t>(item.first))].push_back(item);
+                }
+            }
+
+            std::pair<Key, Value> res = buckets_[0].back();
+            buckets_[0].pop_back();
+            --size_;
+            return res;
+        }
+
+        bool Empty() const {
+            return size_ == 0;
+        }
+
+    private:
+        std::array<std::vector<std::pair<Key, Value>>, 65> buckets_;
+        uint64_t last_ = 0;
+        size_t size_ = 0;
+
+        size_t BucketOf(uint64_t key) const {
+            uint64_t diff = key ^ last_;
+#if defined(__GNUC__)
+            return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+#else
+            size_t bit_width = 0;
+            for (; diff; diff >>= 1) {
+                ++bit_width;
+            }
+            return bit_width;
+#endif
+        }
+    };
+
+
+    template<typename Key, typename Value>
+    using MonotoneQueue = std::conditional_t<std::is_integral_v<Key>, RadixHeapQueue<Key, Value>, BinaryHeapQueue<Key, Value>>;
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Graph {
+
+    // Side table of the edges dropped by CollapseParallelEdges, grouped by the kept edge they are parallel to.
+    // Within a group edges are ordered by weight and then by the order they were added, so the kept edge would
+    // come right before them: the first of a group is the one to take when the kept edge can't be used.
+    template<typename Weight>
+    struct ParallelEdgeTable {
+        std::vector<size_t> group_begin;  // group of kept edge e is [group_begin[e], group_begin[e + 1])
+        std::vector<EdgeId> original_edges;
+        std::vector<Weight> weights;
+
+        size_t Size() const { return original_edges.size(); }
+    };
+
+    template<typename Weight>
+    struct CollapsedGraph {
+        DirectedWeightedGraph<Weight> graph;
+        std::vector<EdgeId> original_edges;  // by new edge id
+        ParallelEdgeTable<Weight> dropped_edges;  // groups by new edge id
+    };
+
+    // Copy of the graph with a single edge per (from, to) pair: the lightest one, the earliest added among
+    // equally light ones, which is the edge both Router and LazyRouter would pick anyway.
+    // Kept edges preserve their relative order, so routes and their tie-breaking do not change.
+    // The other edges of every pair go to the side table, see ParallelEdgeTable.
+    template<typename Weight>
+    CollapsedGraph<Weight> CollapseParallelEdges(const DirectedWeightedGraph<Weight> &graph) {
+        constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+        const size_t vertex_count = graph.GetVertexCount();
+        const size_t edge_count = graph.GetEdgeCount();
+
+        // lightest edge to every head vertex, the scratch row is reset after each tail vertex
+        std::vector<EdgeId> lightest_by_head(vertex_count, NO_EDGE);
+        std::vector<EdgeId> lightest(edge_count);
+        for (VertexId from = 0; from < vertex_count; ++from) {
+            for (const EdgeId edge_id : graph.GetIncidentEdges(from)) {
+                const auto &edge = graph.GetEdge(edge_id);
+                EdgeId &best = lightest_by_head[edge.to];
+                if (best == NO_EDGE || edge.weight < graph.GetEdge(best).weight) {
+                    best = edge_id;
+                }
+            }
+            for (const EdgeId edge_id : graph.GetIncidentEdges(from)) {
+                lightest[edge_id] = lightest_by_head[graph.GetEdge(edge_id).to];
+            }
+            for (const EdgeId edge_id : graph.GetIncidentEdges(from)) {
+                lightest_by_head[graph.GetEdge(edge_id).to] = NO_EDGE;
+            }
+        }
+
+        CollapsedGraph<Weight> res{DirectedWeightedGraph<Weight>(vertex_count), {}, {}};
+        std::vector<EdgeId> new_ids(edge_count);
+        for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+            if (lightest[edge_id] == edge_id) {
+                new_ids[edge_id] = res.graph.AddEdge(graph.GetEdge(edge_id));
+                res.original_edges.push_back(edge_id);
+            }
+        }
+
+        // dropped edges are bucketed by the new id of their kept edge, then every group is sorted
+        ParallelEdgeTable<Weight> &table = res.dropped_edges;
+        table.group_begin.assign(res.original_edges.size() + 1, 0);
+        for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+            if (lightest[edge_id] != edge_id) {
+                ++table.group_begin[new_ids[lightest[edge_id]] + 1];
+            }
+        }
+        for (size_t i = 1; i < table.group_begin.size(); ++i) {
+            table.group_begin[i] += table.group_begin[i - 1];
+        }
+        table.original_edges.resize(table.group_begin.back());
+        std::vector<size_t> group_end(table.group_begin.begin(), table.group_begin.end() - 1);
+        for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+            if (lightest[edge_id] != edge_id) {
+                table.original_edges[group_end[new_ids[lightest[edge_id]]]++] = edge_id;
+            }
+        }
+        for (size_t group = 0; group + 1 < table.group_begin.size(); ++group) {
+            std::stable_sort(table.original_edges.begin() + table.group_begin[group],
+                             table.original_edges.begin() + table.group_begin[group + 1],
+                             [&graph](EdgeId lhs, EdgeId rhs) {
+                                 return graph.GetEdge(lhs).weight < graph.GetEdge(rhs).weight;
+                             });
+        }
+        table.weights.reserve(table.Size());
+        for (const EdgeId edge_id : table.original_edges) {
+            table.weights.push_back(graph.GetEdge(edge_id).weight);
+        }
+        return res;
+    }
+
+}
@@ -1,5 +1,8 @@
 #include "parse_input.h"
 
+#include <algorithm>
+#include <iterator>
+
 using namespace std;
 
 AddStopRequest ParseStopInputRequestJson(const Json::Node &stop_req) {
@@ -17,20 +20,14 @@ AddStopRequest ParseStopInputRequestJson(const Json::Node &stop_req) {
 
 AddBusRequest ParseBusInputRequestJson(const Json::Node &bus_req) {
     string bus_name = bus_req.AsMap().at("name").AsString();
-    bool is_circular = bus_req.AsMap().at("is_roundtrip").AsBool();
+    bool is_roundtrip = bus_req.AsMap().at("is_roundtrip").AsBool();
     vector<string> stops;
 
     for (const Json::Node &stop_node : bus_req.AsMap().at("stops").AsArray()) {
         stops.push_back(stop_node.AsString());
     }
 
-    if (!is_circular) {  // зациклить
-        for (int i = static_cast<int>(stops.size()) - 2; i >= 0; --i) {
-            stops.push_back(stops[i]);
-        }
-    }
-
-    return AddBusRequest{move(bus_name), move(stops)};
+    return AddBusRequest{move(bus_name), move(stops), is_roundtrip};
 }
 
 
@@ -50,6 +47,16 @@ DbInputRequests ParseDbInputJson(const Json::Node &input_requests) {
     return res;
 }
 
+void IngestDbInputRequestJson(const Json::Node &input_request, StreamingIngestor &ingestor) {
+    if (input_request.AsMap().at("type").AsString() == "Stop") {
+        ingestor.AddStop(ParseStopInputRequestJson(input_request));
+    } else if (input_request.AsMap().at("type").AsString() == "Bus") {
+        ingestor.AddBus(ParseBusInputRequestJson(input_request));
+    } else {
+        throw runtime_error("");
+    }
+}
+
 
 // ===========================================================================================
 
@@ -76,45 +83,147 @@ std::unique_ptr<GetRouteRequest> ParseReadRouteRequestJson(const Json::Node &rea
     return make_unique<GetRouteRequest>(id, move(stop_from), move(stop_to));
 }
 
+std::unique_ptr<GetIsochroneRequest> ParseReadIsochroneRequestJson(const Json::Node &read_isochrone_req_node) {
+    int id = static_cast<int>(read_isochrone_req_node.AsMap().at("id").AsDouble());
+    string stop_from = read_isochrone_req_node.AsMap().at("from").AsString();
+    double max_time = read_isochrone_req_node.AsMap().at("max_time").AsDouble();
+
+    return make_unique<GetIsochroneRequest>(id, move(stop_from), max_time);
+}
+
+std::unique_ptr<GetRoutesRequest> ParseReadRoutesRequestJson(const Json::Node &read_routes_req_node) {
+    int id = static_cast<int>(read_routes_req_node.AsMap().at("id").AsDouble());
+    string stop_from = read_routes_req_node.AsMap().at("from").AsString();
+    string stop_to = read_routes_req_node.AsMap().at("to").AsString();
+    // at least the optimal route is always asked for
+    size_t max_count = static_cast<size_t>(max(1.0, read_routes_req_node.AsMap().at("k").AsDouble()));
+    double diversity = read_routes_req_node.AsMap().at("diversity").AsDouble();
+
+    return make_unique<GetRoutesRequest>(id, move(stop_from), move(stop_to), max_count, diversity);
+}
+
+Database::ExportFormat ParseExportFormatJson(const Json::Node &format_node) {
+    if (format_node.AsString() == "csv") {
+        return Database::ExportFormat::csv;
+    } else if (format_node.AsString() == "ndjson") {
+        return Database::ExportFormat::ndjson;
+    } else {
+        throw runtime_error("unknown export format: " + format_node.AsString());
+    }
+}
+
+std::unique_ptr<GetAllBusesRequest> ParseReadAllBusesRequestJson(const Json::Node &read_all_buses_req_node) {
+    int id = static_cast<int>(read_all_buses_req_node.AsMap().at("id").AsDouble());
+    Database::ExportFormat format = ParseExportFormatJson(read_all_buses_req_node.AsMap().at("format"));
+    return make_unique<GetAllBusesRequest>(id, format);
+}
+
+std::unique_ptr<GetAllStopsRequest> ParseReadAllStopsRequestJson(const Json::Node &read_all_stops_req_node) {
+    int id = static_cast<int>(read_all_stops_req_node.AsMap().at("id").AsDouble());
+    Database::ExportFormat format = ParseExportFormatJson(read_all_stops_req_node.AsMap().at("format"));
+    return make_unique<GetAllStopsRequest>(id, format);
+}
+
+unique_ptr<ReadRequest> ParseReadRequestJson(const Json::Node &read_req_node) {
+    if (read_req_node.AsMap().at("type").AsString() == "Stop") {
+        return ParseReadStopRequestJson(read_req_node);
+    } else if (read_req_node.AsMap().at("type").AsString() == "Bus") {
+        return ParseReadBusRequestJson(read_req_node);
+    } else if (read_req_node.AsMap().at("type").AsString() == "Route") {
+        return ParseReadRouteRequestJson(read_req_node);
+    } else if (read_req_node.AsMap().at("type").AsString() == "Isochrone") {
+        return ParseReadIsochroneRequestJson(read_req_node);
+    } else if (read_req_node.AsMap().at("type").AsString() == "Routes") {
+        return ParseReadRoutesRequestJson(read_req_node);
+    } else if (read_req_node.AsMap().at("type").AsString() == "AllBuses") {
+        return ParseReadAllBusesRequestJson(read_req_node);
+    } else if (read_req_node.AsMap().at("type").AsString() == "AllStops") {
+        return ParseReadAllStopsRequestJson(read_req_node);
+    } else {
+        throw runtime_error("");
+    }
+}
+
 vector<unique_ptr<ReadRequest>> ParseReadRequestsJson(const Json::Node &read_requests) {
     vector<unique_ptr<ReadRequest>> res;
 
     for (const Json::Node &read_req_node : read_requests.AsArray()) {
-        if (read_req_node.AsMap().at("type").AsString() == "Stop") {
-            res.push_back(ParseReadStopRequestJson(read_req_node));
-        } else if (read_req_node.AsMap().at("type").AsString() == "Bus") {
-            res.push_back(ParseReadBusRequestJson(read_req_node));
-        } else if (read_req_node.AsMap().at("type").AsString() == "Route") {
-            res.push_back(ParseReadRouteRequestJson(read_req_node));
-        } else {
-            throw runtime_error("");
-        }
+        res.push_back(ParseReadRequestJson(read_req_node));
     }
 
     return res;
 }
 
+vector<unique_ptr<ReadRequest>> ParseWarmupRequestsJson(string_view input) {
+    Json::Document doc = Json::Load(input);
+    vector<unique_ptr<ReadRequest>> res;
+
+    for (const Json::Node &warmup_req_node : doc.GetRoot().AsArray()) {
+        if (warmup_req_node.AsMap().count("type")) {
+            res.push_back(ParseReadRequestJson(warmup_req_node));
+        } else {  // hot pair
+            res.push_back(make_unique<GetRouteRequest>(0, warmup_req_node.AsMap().at("from").AsString(),
+                                                       warmup_req_node.AsMap().at("to").AsString()));
+        }
+    }
+
+    return res;
+}
 
 // ===========================================================================================
 
 
 RoutingSettings ParseRoutingSettingsJson(const Json::Node &routing_settings_node) {
-    return RoutingSettings{
-            static_cast<int>(routing_settings_node.AsMap().at("bus_wait_time").AsDouble()),
-            static_cast<int>(routing_settings_node.AsMap().at("bus_velocity").AsDouble())
-    };
+    RoutingSettings res;
+    res.bus_wait_time = static_cast<int>(routing_settings_node.AsMap().at("bus_wait_time").AsDouble());
+    res.bus_velocity = static_cast<int>(routing_settings_node.AsMap().at("bus_velocity").AsDouble());
+
+    auto lazy_router_it = routing_settings_node.AsMap().find("lazy_router_memory_mb");
+    if (lazy_router_it != routing_settings_node.AsMap().end()) {
+        res.lazy_router_memory_budget_bytes = static_cast<size_t>(lazy_router_it->second.AsDouble() * 1024 * 1024);
+    }
+    auto walking_radius_it = routing_settings_node.AsMap().find("walking_radius");
+    if (walking_radius_it != routing_settings_node.AsMap().end()) {
+        res.walking_radius = walking_radius_it->second.AsDouble();
+    }
+    auto walking_velocity_it = routing_settings_node.AsMap().find("walking_velocity");
+    if (walking_velocity_it != routing_settings_node.AsMap().end()) {
+        res.walking_velocity = walking_velocity_it->second.AsDouble();
+    }
+    return res;
 }
 
 
 // ===========================================================================================
 
 
-tuple<DbInputRequests, vector<unique_ptr<ReadRequest>>, RoutingSettings> ParseRequestsJson(istream& is) {
-    Json::Document doc = Json::Load(is);
+tuple<DbInputRequests, vector<unique_ptr<ReadRequest>>, RoutingSettings> ParseRequestsJson(string_view input) {
+    Json::Document doc = Json::Load(input);
     return make_tuple(
             ParseDbInputJson(doc.GetRoot().AsMap().at("base_requests")),
             ParseReadRequestsJson(doc.GetRoot().AsMap().at("stat_requests")),
             ParseRoutingSettingsJson(doc.GetRoot().AsMap().at("routing_settings"))
     );
+}
+
+tuple<DbInputRequests, vector<unique_ptr<ReadRequest>>, RoutingSettings> ParseRequestsJson(istream& is) {
+    const string input(istreambuf_iterator<char>(is), {});
+    return ParseRequestsJson(string_view(input));
+}
+
+tuple<vector<unique_ptr<ReadRequest>>, RoutingSettings> IngestRequestsJson(string_view input, Database &db) {
+    StreamingIngestor ingestor(db);
+    Json::Document doc = Json::LoadStreaming(input, "base_requests", [&ingestor](Json::Node input_request) {
+        IngestDbInputRequestJson(input_request, ingestor);
+    });
+    ingestor.Finish();
+    return make_tuple(
+            ParseReadRequestsJson(doc.GetRoot().AsMap().at("stat_requests")),
+            ParseRoutingSettingsJson(doc.GetRoot().AsMap().at("routing_settings"))
+    );
+}
 
-}
\ No newline at end of file
+tuple<vector<unique_ptr<ReadRequest>>, RoutingSettings> IngestRequestsJson(istream &is, Database &db) {
+    const string input(istreambuf_iterator<char>(is), {});
+    return IngestRequestsJson(string_view(input), db);
+}
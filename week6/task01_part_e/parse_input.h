@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <memory>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -9,6 +10,7 @@
 #include "requests_input.h"
 #include "requests_read.h"
 #include "routing_settings.h"
+#include "streaming_ingest.h"
 
 AddStopRequest ParseStopInputRequestJson(const Json::Node &stop_req);
 
@@ -16,6 +18,9 @@ AddBusRequest ParseBusInputRequestJson(const Json::Node &bus_req);
 
 DbInputRequests ParseDbInputJson(const Json::Node &input_requests);
 
+// one element of base_requests, streaming alternative to ParseDbInputJson + Database::ApplyFillRequests
+void IngestDbInputRequestJson(const Json::Node &input_request, StreamingIngestor &ingestor);
+
 // ===========================================================================================
 
 std::unique_ptr<GetStopRequest> ParseReadStopRequestJson(const Json::Node &stop_req);
@@ -24,12 +29,36 @@ std::unique_ptr<GetBusRequest>  ParseReadBusRequestJson(const Json::Node &stop_r
 
 std::unique_ptr<GetRouteRequest> ParseReadRouteRequestJson(const Json::Node &stop_req);
 
+std::unique_ptr<GetIsochroneRequest> ParseReadIsochroneRequestJson(const Json::Node &isochrone_req);
+
+std::unique_ptr<GetRoutesRequest> ParseReadRoutesRequestJson(const Json::Node &routes_req);
+
+Database::ExportFormat ParseExportFormatJson(const Json::Node &format_node);
+
+std::unique_ptr<GetAllBusesRequest> ParseReadAllBusesRequestJson(const Json::Node &all_buses_req);
+
+std::unique_ptr<GetAllStopsRequest> ParseReadAllStopsRequestJson(const Json::Node &all_stops_req);
+
+std::unique_ptr<ReadRequest> ParseReadRequestJson(const Json::Node &read_req_node);
+
 std::vector<std::unique_ptr<ReadRequest>> ParseReadRequestsJson(const Json::Node &read_requests);
 
+// JSON array of stat requests (e.g. a sample of recently served ones) or of {"from", "to"} hot route pairs
+std::vector<std::unique_ptr<ReadRequest>> ParseWarmupRequestsJson(std::string_view input);
+
 // ===========================================================================================
 
 RoutingSettings ParseRoutingSettingsJson(const Json::Node &routing_settings_node);
 
 // ===========================================================================================
 
+std::tuple<DbInputRequests, std::vector<std::unique_ptr<ReadRequest>>, RoutingSettings> ParseRequestsJson(std::string_view input);
+
 std::tuple<DbInputRequests, std::vector<std::unique_ptr<ReadRequest>>, RoutingSettings> ParseRequestsJson(std::istream &is);
+
+// base_requests go into db one by one as they are parsed (see Json::LoadStreaming) instead of being returned,
+// so besides the input text only the database and the stat requests are kept
+std::tuple<std::vector<std::unique_ptr<ReadRequest>>, RoutingSettings> IngestRequestsJson(std::string_view input, Database &db);
+
+// reads the whole stream into memory first, pass a file to InputBuffer to have it mapped instead
+std::tuple<std::vector<std::unique_ptr<ReadRequest>>, RoutingSettings> IngestRequestsJson(std::istream &is, Database &db);
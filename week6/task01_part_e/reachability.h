@@ -0,0 +1,54 @@
+#pragma once
+
+#include "graph.h"
+#include "monotone_queue.h"
+
+#include <optional>
+#include <vector>
+
+namespace Graph {
+
+    template<typename Weight>
+    struct ReachedVertex {
+        VertexId vertex;
+        Weight weight;
+    };
+
+    // One-to-all Dijkstra bounded by max_weight: farther candidates are never queued, so the search ends
+    // once everything within the budget is settled. Integer weights use a radix heap (see MonotoneQueue).
+    // Returns every vertex within max_weight from `from` (including itself), ordered by weight.
+    template<typename Weight>
+    std::vector<ReachedVertex<Weight>> FindReachableVertices(const DirectedWeightedGraph<Weight> &graph, VertexId from, Weight max_weight) {
+        std::vector<std::optional<Weight>> dist(graph.GetVertexCount());
+        std::vector<bool> settled(graph.GetVertexCount());
+        std::vector<ReachedVertex<Weight>> res;
+
+        MonotoneQueue<Weight, VertexId> queue;
+        if (max_weight < 0) {
+            return res;
+        }
+        dist[from] = 0;
+        queue.Push(0, from);
+
+        while (!queue.Empty()) {
+            const auto[weight, vertex] = queue.Pop();
+            if (settled[vertex]) {
+                continue;
+            }
+            settled[vertex] = true;
+            res.push_back({vertex, weight});
+
+            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto &edge = graph.GetEdge(edge_id);
+                const Weight candidate = weight + edge.weight;
+                if (candidate <= max_weight && (!dist[edge.to] || candidate < *dist[edge.to])) {
+                    dist[edge.to] = candidate;
+                    queue.Push(candidate, edge.to);
+                }
+            }
+        }
+
+        return res;
+    }
+
+}
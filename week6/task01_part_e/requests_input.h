@@ -17,6 +17,7 @@ struct AddStopRequest {
 struct AddBusRequest {
     std::string bus_name;
     std::vector<std::string> stops;
+    bool is_roundtrip;
 };
 
 struct DbInputRequests {
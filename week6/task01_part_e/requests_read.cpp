@@ -1,6 +1,7 @@
 #include <iomanip>
 #include <sstream>
 
+#include "json.h"
 #include "requests_read.h"
 
 using namespace std;
@@ -20,7 +21,7 @@ string ReadRequest::ServeRequestByJsonData(const std::string &json_data, bool is
 }
 
 
-GetStopRequest::GetStopRequest(int id, std::string stop_name_) : stop_name(move(stop_name_)), ReadRequest(id) {}
+GetStopRequest::GetStopRequest(int id, std::string stop_name_) : ReadRequest(id), stop_name(move(stop_name_)) {}
 
 std::string GetStopRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
     stringstream ss;
@@ -42,12 +43,12 @@ std::string GetStopRequest::ServeRequestJson(const Database &db, bool is_last_in
 }
 
 
-GetBusRequest::GetBusRequest(int id, string bus_name_) : bus_name(move(bus_name_)), ReadRequest(id) {}
+GetBusRequest::GetBusRequest(int id, string bus_name_) : ReadRequest(id), bus_name(move(bus_name_)) {}
 
 std::string GetBusRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
 
     stringstream ss;
-    const Database::Bus *bus_info = db.GetBusInfo(bus_name);
+    const optional<Database::BusStats> bus_info = db.GetBusStats(bus_name);
     if (!bus_info) {
         ss << "    \"error_message\": \"not found\"\n";
     } else {
@@ -61,7 +62,7 @@ std::string GetBusRequest::ServeRequestJson(const Database &db, bool is_last_in_
 }
 
 
-GetRouteRequest::GetRouteRequest(int id, std::string stop_from_, std::string stop_to_) : stop_from(move(stop_from_)), stop_to(move(stop_to_)), ReadRequest(id) {}
+GetRouteRequest::GetRouteRequest(int id, std::string stop_from_, std::string stop_to_) : ReadRequest(id), stop_from(move(stop_from_)), stop_to(move(stop_to_)) {}
 
 std::string GetRouteRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
     stringstream ss;
@@ -84,3 +85,90 @@ std::string GetRouteRequest::ServeRequestJson(const Database &db, bool is_last_i
 
     return ReadRequest::ServeRequestByJsonData(ss.str(), is_last_in_list);
 }
+
+
+GetIsochroneRequest::GetIsochroneRequest(int id, std::string stop_from_, double max_time_) : ReadRequest(id), stop_from(move(stop_from_)), max_time(max_time_) {}
+
+std::string GetIsochroneRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
+    stringstream ss;
+
+    optional<vector<Database::ReachedStop>> reached_stops = db.GetReachableStops(stop_from, max_time);
+    if (!reached_stops) {
+        ss << "    \"error_message\": \"not found\"\n";
+    } else {
+        ss << "    \"stops\": [\n";
+        for (size_t i = 0; i < reached_stops->size(); ++i) {
+            const Database::ReachedStop &reached = (*reached_stops)[i];
+            ss << "      {\n";
+            ss << "        \"stop_name\": \"" << *reached.stop_name << "\",\n";
+            ss << "        \"time\": " << setprecision(6) << reached.time << "\n";
+            ss << "      }" << (i + 1 == reached_stops->size() ? "" : ",") << "\n";
+        }
+        ss << "    ]\n";
+    }
+
+    return ReadRequest::ServeRequestByJsonData(ss.str(), is_last_in_list);
+}
+
+
+GetRoutesRequest::GetRoutesRequest(int id, std::string stop_from_, std::string stop_to_, size_t max_count_, double diversity_)
+        : ReadRequest(id), stop_from(move(stop_from_)), stop_to(move(stop_to_)), max_count(max_count_), diversity(diversity_) {}
+
+std::string GetRoutesRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
+    stringstream ss;
+
+    vector<Database::RouteInfoRes> routes = db.GetAlternativeRoutesInfo(stop_from, stop_to, max_count, diversity);
+    if (routes.empty()) {
+        ss << "    \"error_message\": \"not found\"\n";
+    } else {
+        ss << "    \"routes\": [\n";
+        for (size_t route_idx = 0; route_idx < routes.size(); ++route_idx) {
+            const Database::RouteInfoRes &route = routes[route_idx];
+            ss << "      {\n";
+            ss << "        \"total_time\": " << route.time << ",\n";
+            ss << "        \"items\": [\n";
+            for (size_t item_idx = 0; item_idx < route.items.size(); ++item_idx) {
+                ss << route.items[item_idx]->GetInfoJson(10, item_idx + 1 == route.items.size());
+            }
+            ss << "        ]\n";
+            ss << "      }" << (route_idx + 1 == routes.size() ? "" : ",") << "\n";
+        }
+        ss << "    ]\n";
+    }
+
+    return ReadRequest::ServeRequestByJsonData(ss.str(), is_last_in_list);
+}
+
+
+GetAllBusesRequest::GetAllBusesRequest(int id, Database::ExportFormat format_) : ReadRequest(id), format(format_) {}
+
+std::string GetAllBusesRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
+    stringstream ss;
+
+    // rows are formatted straight into the answer, escaped on the way as the inside of a JSON string
+    ss << "    \"rows\": \"";
+    Json::StringEscapeBuf rows_buf(ss);
+    ostream rows(&rows_buf);
+    const size_t row_count = db.ExportBusStats(rows, format);
+    ss << "\",\n";
+    ss << "    \"row_count\": " << row_count << "\n";
+
+    return ReadRequest::ServeRequestByJsonData(ss.str(), is_last_in_list);
+}
+
+
+GetAllStopsRequest::GetAllStopsRequest(int id, Database::ExportFormat format_) : ReadRequest(id), format(format_) {}
+
+std::string GetAllStopsRequest::ServeRequestJson(const Database &db, bool is_last_in_list) const {
+    stringstream ss;
+
+    // rows are formatted straight into the answer, escaped on the way as the inside of a JSON string
+    ss << "    \"rows\": \"";
+    Json::StringEscapeBuf rows_buf(ss);
+    ostream rows(&rows_buf);
+    const size_t row_count = db.ExportStopBuses(rows, format);
+    ss << "\",\n";
+    ss << "    \"row_count\": " << row_count << "\n";
+
+    return ReadRequest::ServeRequestByJsonData(ss.str(), is_last_in_list);
+}
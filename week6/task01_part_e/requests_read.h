@@ -52,3 +52,54 @@ public:
 private:
     std::string stop_from, stop_to;
 };
+
+
+// All stops reachable from stop_from within max_time minutes
+class GetIsochroneRequest : public ReadRequest {
+public:
+    GetIsochroneRequest(int id, std::string stop_from_, double max_time_);
+
+    std::string ServeRequestJson(const Database &db, bool is_last_in_list) const override;
+
+private:
+    std::string stop_from;
+    double max_time;
+};
+
+
+// Up to max_count alternative routes, each at least `diversity` (0..1) different from the others
+class GetRoutesRequest : public ReadRequest {
+public:
+    GetRoutesRequest(int id, std::string stop_from_, std::string stop_to_, size_t max_count_, double diversity_);
+
+    std::string ServeRequestJson(const Database &db, bool is_last_in_list) const override;
+
+private:
+    std::string stop_from, stop_to;
+    size_t max_count;
+    double diversity;
+};
+
+
+// Bulk export of the whole bus statistics table (see Database::ExportBusStats), returned in the answer as one string
+class GetAllBusesRequest : public ReadRequest {
+public:
+    GetAllBusesRequest(int id, Database::ExportFormat format_);
+
+    std::string ServeRequestJson(const Database &db, bool is_last_in_list) const override;
+
+private:
+    Database::ExportFormat format;
+};
+
+
+// Bulk export of the bus list of every stop (see Database::ExportStopBuses), returned in the answer as one string
+class GetAllStopsRequest : public ReadRequest {
+public:
+    GetAllStopsRequest(int id, Database::ExportFormat format_);
+
+    std::string ServeRequestJson(const Database &db, bool is_last_in_list) const override;
+
+private:
+    Database::ExportFormat format;
+};
@@ -0,0 +1,58 @@
+#include "road_distances.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+using namespace std;
+
+
+void RoadDistanceTable::Build(size_t stop_count, const vector<Entry> &entries) {
+    struct Directed {
+        uint32_t from_id;
+        uint32_t to_id;
+        bool is_reversed;  // filled from the opposite direction
+        double meters;
+    };
+
+    vector<Directed> directed;
+    directed.reserve(entries.size() * 2);
+    for (const Entry &entry : entries) {
+        directed.push_back({entry.from_id, entry.to_id, false, entry.meters});
+        directed.push_back({entry.to_id, entry.from_id, true, entry.meters});
+    }
+
+    // explicit distance goes first among equal (from, to), duplicates after it are dropped
+    sort(directed.begin(), directed.end(), [](const Directed &lhs, const Directed &rhs) {
+        return tie(lhs.from_id, lhs.to_id, lhs.is_reversed) < tie(rhs.from_id, rhs.to_id, rhs.is_reversed);
+    });
+    directed.erase(unique(directed.begin(), directed.end(), [](const Directed &lhs, const Directed &rhs) {
+        return lhs.from_id == rhs.from_id && lhs.to_id == rhs.to_id;
+    }), directed.end());
+
+    row_begin.assign(stop_count + 1, 0);
+    to_ids.clear();
+    meters.clear();
+    to_ids.reserve(directed.size());
+    meters.reserve(directed.size());
+    for (const Directed &item : directed) {
+        ++row_begin[item.from_id + 1];
+        to_ids.push_back(item.to_id);
+        meters.push_back(item.meters);
+    }
+    for (size_t i = 1; i <= stop_count; ++i) {
+        row_begin[i] += row_begin[i - 1];
+    }
+}
+
+double RoadDistanceTable::Get(size_t from_id, size_t to_id) const {
+    if (from_id + 1 < row_begin.size()) {
+        const auto row_first = to_ids.begin() + row_begin[from_id];
+        const auto row_last = to_ids.begin() + row_begin[from_id + 1];
+        const auto it = lower_bound(row_first, row_last, to_id);
+        if (it != row_last && *it == to_id) {
+            return meters[it - to_ids.begin()];
+        }
+    }
+    throw out_of_range("no road distance between stops");
+}
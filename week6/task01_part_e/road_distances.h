@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// Road distances in meters as a CSR table: the row of a stop lists (to_id, meters) sorted by to_id.
+// The reverse direction of every given distance is added at build time unless it is given explicitly,
+// so a lookup never has to fall back to the opposite stop.
+class RoadDistanceTable {
+public:
+    struct Entry {
+        uint32_t from_id;
+        uint32_t to_id;
+        double meters;
+    };
+
+    void Build(size_t stop_count, const std::vector<Entry> &entries);
+
+    // throws std::out_of_range when there is no road between the stops
+    double Get(size_t from_id, size_t to_id) const;
+
+private:
+    std::vector<uint32_t> row_begin;  // row of stop i is [row_begin[i], row_begin[i + 1])
+    std::vector<uint32_t> to_ids;
+    std::vector<double> meters;
+};
@@ -30,3 +30,17 @@ string BusRouteItem::GetInfoJson(int indent_size, bool is_last) const {
     ss << string(indent_size, ' ') << "}" << (is_last ? "" : ",") << "\n";
     return ss.str();
 }
+
+WalkRouteItem::WalkRouteItem(string fromStopName, string toStopName, double time)
+        : from_stop_name(move(fromStopName)), to_stop_name(move(toStopName)), time(time) {}
+
+string WalkRouteItem::GetInfoJson(int indent_size, bool is_last) const {
+    stringstream ss;
+    ss << string(indent_size, ' ') << "{\n";
+    ss << string(indent_size, ' ') << "  \"type\": \"Walk\",\n";
+    ss << string(indent_size, ' ') << "  \"time\": " << setprecision(6) << time << ",\n";
+    ss << string(indent_size, ' ') << "  \"from\": \"" << from_stop_name << "\",\n";
+    ss << string(indent_size, ' ') << "  \"to\": \"" << to_stop_name << "\"\n";
+    ss << string(indent_size, ' ') << "}" << (is_last ? "" : ",") << "\n";
+    return ss.str();
+}
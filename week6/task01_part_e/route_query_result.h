@@ -31,4 +31,16 @@ private:
     double time;
     size_t span_count;
 
-};
\ No newline at end of file
+};
+
+class WalkRouteItem : public RouteItem {
+public:
+    WalkRouteItem(std::string fromStopName, std::string toStopName, double time);
+
+    std::string GetInfoJson(int indent_size, bool is_last) const override;
+
+private:
+    std::string from_stop_name;
+    std::string to_stop_name;
+    double time;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "routing_settings.h"
+
+
+// Weight type of the routing graph, chosen at compile time.
+// With TRANSPORT_INTEGER_WEIGHTS the graph stores fixed-point minutes in units of 1 / (100 * bus_velocity) minute:
+// a ride of d meters takes 6 * d such units, so integer road distances are represented exactly,
+// and integer-only code paths (radix heap Dijkstra) are used by the graph algorithms.
+// Total times are the same as with doubles, but routes that doubles tell apart only by rounding error are exact ties here,
+// so another one of them may be picked.
+#ifdef TRANSPORT_INTEGER_WEIGHTS
+using RouteWeight = int64_t;
+#else
+using RouteWeight = double;
+#endif
+
+
+class RouteWeightScale {
+public:
+    explicit RouteWeightScale(const RoutingSettings &routing_settings) : bus_velocity(routing_settings.bus_velocity) {}
+
+    RouteWeight FromWaitMinutes(int minutes) const {
+#ifdef TRANSPORT_INTEGER_WEIGHTS
+        return static_cast<RouteWeight>(minutes) * 100 * bus_velocity;
+#else
+        return static_cast<double>(minutes);
+#endif
+    }
+
+    RouteWeight FromRideMeters(double meters) const {
+#ifdef TRANSPORT_INTEGER_WEIGHTS
+        return std::llround(meters * 6);
+#else
+        return meters / 1000 / bus_velocity * 60;
+#endif
+    }
+
+    RouteWeight FromWalkMeters(double meters, double walking_velocity) const {
+#ifdef TRANSPORT_INTEGER_WEIGHTS
+        return std::llround(meters * 6 * bus_velocity / walking_velocity);
+#else
+        return meters / 1000 / walking_velocity * 60;
+#endif
+    }
+
+    // largest weight not exceeding the given time
+    RouteWeight FromMinutesFloor(double minutes) const {
+#ifdef TRANSPORT_INTEGER_WEIGHTS
+        return static_cast<RouteWeight>(std::floor(minutes * 100 * bus_velocity));
+#else
+        return minutes;
+#endif
+    }
+
+    double ToMinutes(RouteWeight weight) const {
+#ifdef TRANSPORT_INTEGER_WEIGHTS
+        return static_cast<double>(weight) / (100.0 * bus_velocity);
+#else
+        return weight;
+#endif
+    }
+
+private:
+    int bus_velocity;
+};
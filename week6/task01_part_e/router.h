@@ -31,6 +31,13 @@ namespace Graph {
 
         std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
+        using RouteSummary = ::Graph::RouteSummary<Weight>;
+
+        // Writes route edges in order into [edges_out, edges_out + edge_count) if capacity is enough,
+        // otherwise writes nothing, so the caller can retry with edge_count slots.
+        // Unlike BuildRoute it touches no shared state and allocates nothing.
+        std::optional<RouteSummary> BuildRouteInto(VertexId from, VertexId to, EdgeId *edges_out, size_t capacity) const;
+
         EdgeId GetRouteEdge(RouteId route_id, size_t edge_idx) const;
 
         void ReleaseRoute(RouteId route_id);
@@ -126,6 +133,33 @@ namespace Graph {
         return RouteInfo{route_id, weight, route_edge_count};
     }
 
+    template<typename Weight>
+    std::optional<typename Router<Weight>::RouteSummary>
+    Router<Weight>::BuildRouteInto(VertexId from, VertexId to, EdgeId *edges_out, size_t capacity) const {
+        const auto &route_internal_data = routes_internal_data_[from][to];
+        if (!route_internal_data) {
+            return std::nullopt;
+        }
+
+        size_t edge_count = 0;
+        for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
+             edge_id;
+             edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge) {
+            ++edge_count;
+        }
+
+        if (edge_count <= capacity) {
+            // the chain goes from the end of the route, so fill the output backwards
+            size_t edge_idx = edge_count;
+            for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
+                 edge_id;
+                 edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge) {
+                edges_out[--edge_idx] = *edge_id;
+            }
+        }
+        return RouteSummary{route_internal_data->weight, edge_count};
+    }
+
     template<typename Weight>
     EdgeId Router<Weight>::GetRouteEdge(RouteId route_id, size_t edge_idx) const {
         return expanded_routes_cache_.at(route_id)[edge_idx];
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <optional>
+
 struct RoutingSettings {
-    int bus_wait_time;
-    int bus_velocity;
+    int bus_wait_time = 0;  // minutes
+    int bus_velocity = 0;  // km/h
+    // if set, routes are searched by Graph::LazyRouter with this cache budget instead of the all-pairs Router
+    std::optional<size_t> lazy_router_memory_budget_bytes;
+    // if set, stops not farther than this many meters apart are connected by walking transfers
+    std::optional<double> walking_radius;
+    double walking_velocity = 5;  // km/h
 };
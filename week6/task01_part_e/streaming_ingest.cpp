@@ -0,0 +1,54 @@
+#include "streaming_ingest.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+
+StreamingIngestor::StreamingIngestor(Database &db) : db(db) {}
+
+void StreamingIngestor::AddStop(AddStopRequest stop_req) {
+    db.AddStop(move(stop_req.stop_name), stop_req.coords, move(stop_req.distances));
+
+    // waiting buses are retried each time the number of stops doubles, so each of them is checked O(log stops) times
+    if (!waiting_buses.empty() && db.GetStopCount() >= 2 * stops_at_last_retry) {
+        RetryWaitingBuses();
+    }
+}
+
+void StreamingIngestor::AddBus(AddBusRequest bus_req) {
+    if (!TryAddBus(bus_req)) {
+        waiting_buses.push_back(move(bus_req));
+    }
+}
+
+void StreamingIngestor::Finish() {
+    for (AddBusRequest &bus_req : waiting_buses) {
+        db.AddBus(move(bus_req.bus_name), move(bus_req.stops), bus_req.is_roundtrip);  // throws for unknown stops
+    }
+    waiting_buses.clear();
+    db.FinishFill();
+}
+
+bool StreamingIngestor::TryAddBus(AddBusRequest &bus_req) {
+    vector<size_t> stop_ids;
+    stop_ids.reserve(bus_req.stops.size());
+    for (const string &stop_name : bus_req.stops) {
+        const Database::Stop *stop = db.GetStopInfo(stop_name);
+        if (!stop) {
+            return false;
+        }
+        stop_ids.push_back(stop->id);
+    }
+
+    db.AddBus(move(bus_req.bus_name), move(stop_ids), bus_req.is_roundtrip);
+    return true;
+}
+
+void StreamingIngestor::RetryWaitingBuses() {
+    stops_at_last_retry = db.GetStopCount();
+    waiting_buses.erase(remove_if(waiting_buses.begin(), waiting_buses.end(), [this](AddBusRequest &bus_req) {
+        return TryAddBus(bus_req);
+    }), waiting_buses.end());
+}
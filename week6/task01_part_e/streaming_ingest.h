@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "database.h"
+#include "requests_input.h"
+
+
+// Applies Stop/Bus requests to a Database as they are parsed, instead of collecting DbInputRequests first.
+// Stops are added at once, and so is a bus whose stops are all known. Only a bus with a stop that is not added
+// yet is kept, by its stop names, until that stop arrives or until Finish. Route lengths need the final road
+// distances and are computed by Finish, see Database::FinishFill.
+// Buses may get into the database in another order than with ApplyFillRequests, so among equally fast routes
+// another one may be picked.
+class StreamingIngestor {
+public:
+    explicit StreamingIngestor(Database &db);
+
+    void AddStop(AddStopRequest stop_req);
+
+    void AddBus(AddBusRequest bus_req);
+
+    // adds the buses still waiting, throws std::out_of_range if one of them has a stop that never came
+    void Finish();
+
+private:
+    Database &db;
+    std::vector<AddBusRequest> waiting_buses;  // in arrival order
+    size_t stops_at_last_retry = 0;
+
+    // adds the bus if all its stops are known, returns whether it did
+    bool TryAddBus(AddBusRequest &bus_req);
+
+    void RetryWaitingBuses();
+};
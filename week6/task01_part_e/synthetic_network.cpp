@@ -0,0 +1,179 @@
+#include "synthetic_network.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "coords.h"
+
+using namespace std;
+
+namespace {
+
+    string StopName(size_t stop_idx) {
+        return "Stop " + to_string(stop_idx);
+    }
+
+    string BusName(size_t bus_idx) {
+        return to_string(bus_idx);
+    }
+
+    struct GridPlacement {
+        size_t columns;
+        vector<Coords> coords;
+    };
+
+    GridPlacement PlaceStops(size_t stop_count, mt19937 &gen) {
+        const size_t columns = max<size_t>(1, static_cast<size_t>(ceil(sqrt(static_cast<double>(stop_count)))));
+        uniform_real_distribution<double> jitter(-0.001, 0.001);
+
+        GridPlacement res{columns, {}};
+        res.coords.reserve(stop_count);
+        for (size_t i = 0; i < stop_count; ++i) {
+            res.coords.emplace_back(55.6 + static_cast<double>(i / columns) * 0.005 + jitter(gen),
+                                    37.5 + static_cast<double>(i % columns) * 0.008 + jitter(gen));
+        }
+        return res;
+    }
+
+    vector<size_t> GridNeighbours(size_t stop_idx, size_t stop_count, size_t columns) {
+        vector<size_t> res;
+        if (stop_idx % columns != 0) {
+            res.push_back(stop_idx - 1);
+        }
+        if (stop_idx % columns + 1 < columns && stop_idx + 1 < stop_count) {
+            res.push_back(stop_idx + 1);
+        }
+        if (stop_idx >= columns) {
+            res.push_back(stop_idx - columns);
+        }
+        if (stop_idx + columns < stop_count) {
+            res.push_back(stop_idx + columns);
+        }
+        return res;
+    }
+
+    vector<size_t> WalkBusRoute(size_t length, size_t stop_count, size_t columns, mt19937 &gen) {
+        vector<size_t> res{uniform_int_distribution<size_t>(0, stop_count - 1)(gen)};
+        while (res.size() < length) {
+            vector<size_t> neighbours = GridNeighbours(res.back(), stop_count, columns);
+            if (neighbours.size() > 1 && res.size() > 1) {  // do not step straight back if there is another way
+                neighbours.erase(remove(neighbours.begin(), neighbours.end(), res[res.size() - 2]), neighbours.end());
+            }
+            if (neighbours.empty()) {
+                break;
+            }
+            res.push_back(neighbours[uniform_int_distribution<size_t>(0, neighbours.size() - 1)(gen)]);
+        }
+        return res;
+    }
+
+}
+
+string GenerateBaseRequestsJson(const SyntheticNetworkParams &params) {
+    mt19937 gen(params.seed);
+    const GridPlacement placement = PlaceStops(params.stop_count, gen);
+
+    uniform_real_distribution<double> road_stretch(1.1, 1.4);
+    uniform_real_distribution<double> probability(0, 1);
+    uniform_int_distribution<size_t> route_length(max<size_t>(2, params.min_route_length), max<size_t>(2, params.max_route_length));
+
+    vector<map<size_t, int>> road_distances(params.stop_count);
+    auto ensure_road_distance = [&](size_t from, size_t to) {
+        if (road_distances[from].count(to) || road_distances[to].count(from)) {
+            return;
+        }
+        road_distances[from][to] = static_cast<int>((placement.coords[from] - placement.coords[to]) * road_stretch(gen));
+        if (probability(gen) < 0.3) {  // some roads are longer in the opposite direction
+            road_distances[to][from] = static_cast<int>((placement.coords[from] - placement.coords[to]) * road_stretch(gen));
+        }
+    };
+
+    ostringstream buses_os;
+    for (size_t bus_idx = 0; bus_idx < params.bus_count && params.stop_count > 1; ++bus_idx) {
+        const bool is_roundtrip = probability(gen) < params.roundtrip_share;
+        vector<size_t> route = WalkBusRoute(route_length(gen), params.stop_count, placement.columns, gen);
+        if (is_roundtrip) {
+            route.push_back(route.front());
+        }
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            ensure_road_distance(route[i], route[i + 1]);
+        }
+
+        buses_os << ",\n    {\"type\": \"Bus\", \"name\": \"" << BusName(bus_idx) << "\", \"stops\": [";
+        for (size_t i = 0; i < route.size(); ++i) {
+            buses_os << (i == 0 ? "" : ", ") << '"' << StopName(route[i]) << '"';
+        }
+        buses_os << "], \"is_roundtrip\": " << (is_roundtrip ? "true" : "false") << "}";
+    }
+
+    ostringstream os;
+    os << setprecision(9) << "[";
+    for (size_t stop_idx = 0; stop_idx < params.stop_count; ++stop_idx) {
+        os << (stop_idx == 0 ? "\n" : ",\n") << "    {\"type\": \"Stop\", \"name\": \"" << StopName(stop_idx) << "\", ";
+        os << "\"latitude\": " << placement.coords[stop_idx].GetLatitudeDegrees() << ", ";
+        os << "\"longitude\": " << placement.coords[stop_idx].GetLongitudeDegrees() << ", ";
+        os << "\"road_distances\": {";
+        for (auto it = road_distances[stop_idx].begin(); it != road_distances[stop_idx].end(); ++it) {
+            os << (it == road_distances[stop_idx].begin() ? "" : ", ") << '"' << StopName(it->first) << "\": " << it->second;
+        }
+        os << "}}";
+    }
+    os << buses_os.str() << "\n  ]";
+    return os.str();
+}
+
+string GenerateStatRequestsJson(const SyntheticNetworkParams &params, const QueryMix &query_mix, size_t request_count, int first_id) {
+    mt19937 gen(params.seed + 1 + static_cast<unsigned>(first_id));
+    discrete_distribution<int> request_type({query_mix.bus, query_mix.stop, query_mix.route, query_mix.routes, query_mix.isochrone});
+    uniform_int_distribution<size_t> stop_idx(0, max<size_t>(1, params.stop_count) - 1);
+    uniform_int_distribution<size_t> bus_idx(0, max<size_t>(1, params.bus_count) - 1);
+    uniform_real_distribution<double> probability(0, 1);
+    uniform_int_distribution<int> isochrone_time(10, 60);
+
+    // Route-like requests never get missing names, the catalogue expects known stops there
+    auto maybe_missing = [&](string name) {
+        return probability(gen) < query_mix.missing_name_share ? "Missing " + name : name;
+    };
+
+    ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < request_count; ++i) {
+        os << (i == 0 ? "\n" : ",\n") << "    {\"id\": " << first_id + static_cast<int>(i) << ", ";
+        switch (request_type(gen)) {
+            case 0:
+                os << "\"type\": \"Bus\", \"name\": \"" << maybe_missing(BusName(bus_idx(gen))) << "\"}";
+                break;
+            case 1:
+                os << "\"type\": \"Stop\", \"name\": \"" << maybe_missing(StopName(stop_idx(gen))) << "\"}";
+                break;
+            case 2:
+                os << "\"type\": \"Route\", \"from\": \"" << StopName(stop_idx(gen)) << "\", \"to\": \"" << StopName(stop_idx(gen)) << "\"}";
+                break;
+            case 3:
+                os << "\"type\": \"Routes\", \"from\": \"" << StopName(stop_idx(gen)) << "\", \"to\": \"" << StopName(stop_idx(gen))
+                   << "\", \"k\": 3, \"diversity\": 0.3}";
+                break;
+            default:
+                os << "\"type\": \"Isochrone\", \"from\": \"" << maybe_missing(StopName(stop_idx(gen))) << "\", \"max_time\": "
+                   << isochrone_time(gen) << "}";
+        }
+    }
+    os << "\n  ]";
+    return os.str();
+}
+
+string GenerateSyntheticNetworkJson(const SyntheticNetworkParams &params) {
+    ostringstream os;
+    os << "{\n";
+    os << "  \"routing_settings\": {\"bus_wait_time\": " << params.bus_wait_time << ", \"bus_velocity\": " << params.bus_velocity << "},\n";
+    os << "  \"base_requests\": " << GenerateBaseRequestsJson(params) << ",\n";
+    os << "  \"stat_requests\": " << GenerateStatRequestsJson(params, params.query_mix, params.stat_request_count) << "\n";
+    os << "}\n";
+    return os.str();
+}
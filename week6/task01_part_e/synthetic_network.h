@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+
+// Relative weights of stat request types in a generated stat_requests list
+struct QueryMix {
+    double bus = 1;
+    double stop = 1;
+    double route = 2;
+    double routes = 0;
+    double isochrone = 0;
+    double missing_name_share = 0.02;  // requests to names absent from the catalogue
+};
+
+struct SyntheticNetworkParams {
+    size_t stop_count = 100;
+    size_t bus_count = 20;
+    size_t min_route_length = 5;
+    size_t max_route_length = 20;
+    double roundtrip_share = 0.5;
+    size_t stat_request_count = 100;
+    QueryMix query_mix;
+    int bus_wait_time = 6;
+    int bus_velocity = 40;
+    unsigned seed = 42;
+};
+
+// Stops lie on a jittered grid around Moscow, buses are random walks between neighbouring grid cells,
+// road distances are great-circle distances stretched by 10-40%. The result is deterministic for a seed.
+std::string GenerateBaseRequestsJson(const SyntheticNetworkParams &params);
+
+std::string GenerateStatRequestsJson(const SyntheticNetworkParams &params, const QueryMix &query_mix, size_t request_count, int first_id = 0);
+
+// Full input document: routing_settings, base_requests and stat_requests
+std::string GenerateSyntheticNetworkJson(const SyntheticNetworkParams &params);
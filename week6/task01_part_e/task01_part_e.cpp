@@ -4,36 +4,56 @@
 #include <iomanip>
 #include <memory>
 #include <set>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 
 #include "database.h"
+#include "input_buffer.h"
 #include "parse_input.h"
 #include "profile.h"
 #include "requests_read.h"
+#include "warmup.h"
 
 using namespace std;
 
 
 
 
-int main() {
+// Usage: task01_part_e [input_file [warmup_file]], reads stdin when no file is given.
+// Requests from warmup_file (see ParseWarmupRequestsJson) are served before the real ones, with answers dropped.
+int main(int argc, char *argv[]) {
     Database db;
 
-//    auto opened_file = ifstream("../input/input4.txt");
-//    tuple<DbInputRequests, vector<unique_ptr<ReadRequest>>, RoutingSettings> requests = ParseRequestsJson(opened_file);
-    tuple<DbInputRequests, vector<unique_ptr<ReadRequest>>, RoutingSettings> requests = ParseRequestsJson(cin);
-    DbInputRequests db_input_requests = move(get<0>(requests));
-    vector<unique_ptr<ReadRequest>> read_requests = move(get<1>(requests));
-    RoutingSettings routing_settings = get<2>(requests);
+    // stops and buses are applied to db while parsing, see IngestRequestsJson
+    tuple<vector<unique_ptr<ReadRequest>>, RoutingSettings> requests;
+    if (argc > 1) {
+        // the file is mapped and parsed in place, without copying it through iostreams
+        InputBuffer input(argv[1]);
+        requests = IngestRequestsJson(input.View(), db);
+    } else {
+        requests = IngestRequestsJson(cin, db);
+    }
+    vector<unique_ptr<ReadRequest>> read_requests = move(get<0>(requests));
+    RoutingSettings routing_settings = get<1>(requests);
 
     // =========================================
 
-    db.ApplyFillRequests(move(db_input_requests));
-
-
     db.FillRoutesGraph(routing_settings);
 
+    // a broken warmup file only costs the warmup, the real requests are served anyway
+    if (argc > 2) {
+        try {
+            InputBuffer warmup_input(argv[2]);
+            const size_t skipped_count = WarmUp(db, ParseWarmupRequestsJson(warmup_input.View()), thread::hardware_concurrency());
+            if (skipped_count > 0) {
+                cerr << "warmup: skipped " << skipped_count << " failed requests\n";
+            }
+        } catch (const exception &e) {
+            cerr << "warmup: " << e.what() << "\n";
+        }
+    }
+
     cout << "[\n";
     if (!read_requests.empty()) {
         for (int i = 0; i < read_requests.size() - 1; i++) {
@@ -0,0 +1,71 @@
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "database.h"
+#include "parse_input.h"
+#include "requests_read.h"
+#include "test_runner.h"
+#include "warmup.h"
+
+using namespace std;
+
+
+namespace {
+
+    const string_view CATALOGUE_JSON = R"({
+  "routing_settings": {"bus_wait_time": 6, "bus_velocity": 40, "lazy_router_memory_mb": 1},
+  "base_requests": [
+    {"type": "Stop", "name": "A", "latitude": 55.611087, "longitude": 37.20829, "road_distances": {"B": 3900}},
+    {"type": "Stop", "name": "B", "latitude": 55.595884, "longitude": 37.209755, "road_distances": {}},
+    {"type": "Bus", "name": "1", "stops": ["A", "B"], "is_roundtrip": false}
+  ],
+  "stat_requests": [
+    {"type": "Route", "id": 1, "from": "A", "to": "B"}
+  ]
+})";
+
+}
+
+
+void TestWarmUpSkipsStaleHotPairs() {
+    Database db;
+    auto [read_requests, routing_settings] = IngestRequestsJson(CATALOGUE_JSON, db);
+    db.FillRoutesGraph(routing_settings);
+
+    // hot pairs recorded against an older catalogue, where stop "C" existed
+    const vector<unique_ptr<ReadRequest>> warmup_requests = ParseWarmupRequestsJson(R"([
+        {"from": "A", "to": "B"},
+        {"from": "C", "to": "A"},
+        {"type": "Route", "id": 0, "from": "B", "to": "C"},
+        {"from": "B", "to": "A"}
+    ])");
+
+    size_t skipped_count = 0;
+    try {
+        skipped_count = WarmUp(db, warmup_requests, 2);
+    } catch (...) {
+        Assert(false, "WarmUp must not throw on requests naming unknown stops");
+    }
+    ASSERT_EQUAL(skipped_count, 2u);
+
+    // the real requests are served as usual afterwards
+    const string answer = read_requests[0]->ServeRequestJson(db, true);
+    ASSERT(answer.find("\"total_time\": 11.85") != string::npos);
+}
+
+void TestWarmUpWithoutRequests() {
+    Database db;
+    auto [read_requests, routing_settings] = IngestRequestsJson(CATALOGUE_JSON, db);
+    db.FillRoutesGraph(routing_settings);
+
+    ASSERT_EQUAL(WarmUp(db, {}, 4), 0u);
+}
+
+
+int main() {
+    TestRunner tr;
+    RUN_TEST(tr, TestWarmUpSkipsStaleHotPairs);
+    RUN_TEST(tr, TestWarmUpWithoutRequests);
+    return 0;
+}
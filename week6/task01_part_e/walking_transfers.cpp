@@ -0,0 +1,72 @@
+#include "walking_transfers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+using namespace std;
+
+
+namespace {
+
+    constexpr double EARTH_RADIUS = 6371000;
+    constexpr double PI = 3.1415926535;
+    constexpr double METERS_PER_LATITUDE_DEGREE = EARTH_RADIUS * PI / 180;
+
+    uint64_t CellKey(int64_t row, int64_t column) {
+        return (static_cast<uint64_t>(row) << 32) ^ static_cast<uint32_t>(column);
+    }
+
+}
+
+vector<StopPairDistance> FindStopPairsWithin(const vector<Coords> &stops_coords, double radius_meters) {
+    vector<StopPairDistance> res;
+    if (stops_coords.empty() || radius_meters <= 0) {
+        return res;
+    }
+
+    // a longitude degree is shortest at the latitude farthest from the equator, size cells for it
+    double max_abs_latitude = 0;
+    for (const Coords &coords : stops_coords) {
+        max_abs_latitude = max(max_abs_latitude, fabs(coords.GetLatitudeDegrees()));
+    }
+    const double cell_height = radius_meters / METERS_PER_LATITUDE_DEGREE;
+    const double cell_width = radius_meters / (METERS_PER_LATITUDE_DEGREE * max(cos(max_abs_latitude / 180 * PI), 1e-6));
+
+    auto row_of = [&](const Coords &coords) {
+        return static_cast<int64_t>(floor(coords.GetLatitudeDegrees() / cell_height));
+    };
+    auto column_of = [&](const Coords &coords) {
+        return static_cast<int64_t>(floor(coords.GetLongitudeDegrees() / cell_width));
+    };
+
+    unordered_map<uint64_t, vector<size_t>> grid;
+    for (size_t stop_id = 0; stop_id < stops_coords.size(); ++stop_id) {
+        grid[CellKey(row_of(stops_coords[stop_id]), column_of(stops_coords[stop_id]))].push_back(stop_id);
+    }
+
+    for (size_t from_id = 0; from_id < stops_coords.size(); ++from_id) {
+        const int64_t row = row_of(stops_coords[from_id]);
+        const int64_t column = column_of(stops_coords[from_id]);
+        for (int64_t neighbour_row = row - 1; neighbour_row <= row + 1; ++neighbour_row) {
+            for (int64_t neighbour_column = column - 1; neighbour_column <= column + 1; ++neighbour_column) {
+                auto cell_it = grid.find(CellKey(neighbour_row, neighbour_column));
+                if (cell_it == grid.end()) {
+                    continue;
+                }
+                for (size_t to_id : cell_it->second) {
+                    if (to_id == from_id) {
+                        continue;
+                    }
+                    const double meters = stops_coords[from_id] - stops_coords[to_id];
+                    if (meters <= radius_meters) {
+                        res.push_back({from_id, to_id, meters});
+                    }
+                }
+            }
+        }
+    }
+
+    return res;
+}
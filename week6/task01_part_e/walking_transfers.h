@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "coords.h"
+
+
+struct StopPairDistance {
+    size_t from_id;
+    size_t to_id;
+    double meters;
+};
+
+// All ordered pairs of distinct stops (indexes into stops_coords) not farther than radius_meters apart.
+// Stops are bucketed into a lat/lon grid with cells at least radius_meters wide, so only the 3x3 cells
+// around a stop are checked instead of every other stop.
+std::vector<StopPairDistance> FindStopPairsWithin(const std::vector<Coords> &stops_coords, double radius_meters);
@@ -0,0 +1,34 @@
+#include "warmup.h"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+
+using namespace std;
+
+
+size_t WarmUp(const Database &db, const vector<unique_ptr<ReadRequest>> &requests, size_t thread_count) {
+    thread_count = max<size_t>(1, min(thread_count, requests.size()));
+
+    // requests are dealt round-robin, so a burst of heavy ones in the sample is shared between threads
+    vector<future<size_t>> workers;
+    for (size_t worker_idx = 0; worker_idx < thread_count; ++worker_idx) {
+        workers.push_back(async(launch::async, [&db, &requests, worker_idx, thread_count] {
+            size_t skipped_count = 0;
+            for (size_t request_idx = worker_idx; request_idx < requests.size(); request_idx += thread_count) {
+                try {
+                    requests[request_idx]->ServeRequestJson(db, true);
+                } catch (const exception &) {
+                    ++skipped_count;
+                }
+            }
+            return skipped_count;
+        }));
+    }
+
+    size_t skipped_count = 0;
+    for (future<size_t> &worker : workers) {
+        skipped_count += worker.get();
+    }
+    return skipped_count;
+}
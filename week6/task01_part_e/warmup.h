@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "database.h"
+#include "requests_read.h"
+
+
+// Serve requests against db and drop the answers, so caches filled on first use (LazyRouter trees)
+// are hot before the real queries come. Requests are split between thread_count threads,
+// the call returns when all of them are served.
+// A request that fails (e.g. a stale hot pair naming a stop that is gone) is skipped, warmup never throws.
+// Returns the number of skipped requests.
+size_t WarmUp(const Database &db, const std::vector<std::unique_ptr<ReadRequest>> &requests, size_t thread_count);